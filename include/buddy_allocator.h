@@ -1,15 +1,19 @@
 #pragma once
 
+#include <algorithm>
 #include <array>
+#include <atomic>
 #include <bit>
-#include <bitset>
 #include <cstddef>
+#include <cstdint>
+#include <mutex>
 #include <span>
 #include <string>
 #include <type_traits>
 #include <unordered_map>
 
 #include "common.h"
+#include "mmap_buffer.h"
 
 namespace allocator {
 
@@ -18,10 +22,36 @@ struct Block {
   Block* previous;
 };
 
-template <size_t S, BufferType B = BufferType::HEAP>
+// with Concurrency::PER_LEVEL, allocate(), deallocate() and trim() may be
+// called from any thread, while reset() and get_state() may not
+template <size_t S, BufferType B = BufferType::HEAP,
+          Tracking M = Tracking::NONE, Decommit D = Decommit::NONE,
+          Concurrency C = Concurrency::NONE>
 class BuddyAllocator {
+  static_assert(C == Concurrency::NONE || M == Tracking::NONE,
+                "the allocation map is not thread-safe");
+  static_assert(C != Concurrency::OWNER,
+                "remote frees are not supported, use Concurrency::PER_LEVEL");
+
  public:
+  static constexpr size_t extent = S;
   static constexpr BufferType buffer_type = B;
+  static constexpr Tracking tracking = M;
+  static constexpr Decommit decommit_policy = D;
+  static constexpr Concurrency concurrency = C;
+
+  // owned buffers are aligned to this, so any alignment up to it can be
+  // served by picking a block on a suitable offset. external buffers are
+  // aligned to alignof(std::max_align_t), and further towards it only as
+  // far as their spare bytes allow. alignments above the buffer's own are
+  // served by address instead, from blocks no larger than the buffer's
+  // alignment, and allocate_bulk() does not serve them
+  static constexpr size_t base_alignment{
+      std::max(std::min(S, page_size), alignof(std::max_align_t))};
+
+  // smallest free block whose pages are returned to the OS by default,
+  // below it the system calls would cost more than the memory is worth
+  static constexpr size_t decommit_threshold{16 * page_size};
 
   // NOTE: size must be a power of 2
   explicit BuddyAllocator()
@@ -30,6 +60,17 @@ class BuddyAllocator {
     requires(S > 0 && (S & (S - 1)) == 0 && B == BufferType::STACK);
   explicit BuddyAllocator(std::array<std::byte, S>& buf)
     requires(S > 0 && (S & (S - 1)) == 0 && B == BufferType::EXTERNAL);
+  explicit BuddyAllocator(MapOptions options = {})
+    requires(S > 0 && (S & (S - 1)) == 0 && B == BufferType::MMAP);
+
+  // capacity chosen at construction, with S = dynamic_extent. rounded down
+  // to a power of 2
+  explicit BuddyAllocator(size_t size)
+    requires(S == dynamic_extent && B == BufferType::HEAP);
+  explicit BuddyAllocator(std::span<std::byte> buf)
+    requires(S == dynamic_extent && B == BufferType::EXTERNAL);
+  explicit BuddyAllocator(size_t size, MapOptions options = {})
+    requires(S == dynamic_extent && B == BufferType::MMAP);
   ~BuddyAllocator() noexcept;
 
   BuddyAllocator(const BuddyAllocator&) = delete;
@@ -39,9 +80,39 @@ class BuddyAllocator {
   BuddyAllocator& operator=(BuddyAllocator&&) = delete;
 
   [[nodiscard]] std::byte* allocate(size_t size) noexcept;
+  [[nodiscard]] std::byte* allocate(size_t size, size_t alignment) noexcept;
   void deallocate(std::byte* ptr) noexcept;
+  // size and alignment as passed to allocate() or allocate_bulk(), whose
+  // level then follows from size without loading it, unless alignment is
+  // larger than the block size alone needs
+  void deallocate(std::byte* ptr, size_t size, size_t alignment) noexcept;
   void reset() noexcept;
 
+  // resizes the block at ptr in place where it can, freeing its upper
+  // halves to shrink, or taking the free buddies after it to grow, and
+  // moves it to a block aligned to alignment otherwise. returns nullptr,
+  // leaving ptr as it was, if it cannot be resized
+  [[nodiscard]] std::byte* reallocate(std::byte* ptr, size_t new_size,
+                                      size_t alignment) noexcept;
+
+  // up to count blocks of size bytes, each free block found split only as
+  // far as the blocks it yields need. siblings are only aligned to their
+  // own size, so alignment rounds the block size up as well. writes them to
+  // out and returns how many fit, less than count only when out or the
+  // free blocks run out
+  [[nodiscard]] size_t allocate_bulk(size_t count, size_t size,
+                                     size_t alignment,
+                                     std::span<std::byte*> out) noexcept;
+  // frees every block in ptrs, skipping nullptr. siblings that follow
+  // each other, as allocate_bulk() returns them, are merged before they
+  // reach the free lists
+  void deallocate_bulk(std::span<std::byte*> ptrs) noexcept;
+
+  // returns the pages of free blocks of at least threshold bytes to the OS,
+  // keeping the page that holds each block's links. returns the bytes
+  // released, which read back as zero once allocated again
+  size_t trim(size_t threshold = decommit_threshold) noexcept;
+
   std::string get_state() const noexcept;
 
   size_t get_used() const noexcept;
@@ -64,22 +135,99 @@ class BuddyAllocator {
 
  private:
   Block* get_buddy(Block* block, size_t level) const noexcept;
+  // unlinks and claims a free block below aligned_level that happens to be
+  // aligned, setting found to its level
+  Block* find_aligned(size_t level, size_t aligned_level, size_t alignment,
+                      size_t& found) noexcept;
   void unlink(Block* block, size_t level) noexcept;
-
-  std::conditional_t<B == BufferType::STACK, std::array<std::byte, S>,
-                     std::byte*>
-      buffer;
+  void push(Block* block, size_t level) noexcept;
+
+  // clears bit, the allocated or split bit of a block at level, and hands
+  // the block back to the free lists merged with any free buddies
+  void release(Block* block, size_t level, size_t bit) noexcept;
+
+  // marks the block at level at as split, or as allocated once at level
+  void claim(Block* block, size_t at, size_t level) noexcept;
+  // takes the blocks of level inside a claimed block at level at, in
+  // address order, until out is full, and frees the halves left over
+  size_t split_bulk(Block* block, size_t at, size_t level,
+                    std::span<std::byte*> out) noexcept;
+
+  // holds the lock of level while alive, or nothing without concurrency.
+  // user-provided, so the locals holding one don't read as unused
+  struct Unlocked {
+    Unlocked() noexcept {}
+  };
+  auto lock_level(size_t level) noexcept;
+  size_t decommit(Block* block, size_t level) noexcept;
+
+  alignas(B == BufferType::STACK ? base_alignment : alignof(std::byte*))
+      std::conditional_t<B == BufferType::STACK, std::array<std::byte, S>,
+                         std::byte*> buffer;
   std::byte* data;
   size_t capacity;
-  size_t used;
-
-  static constexpr size_t max_level{std::bit_width(S / sizeof(Block)) - 1};
-  std::array<Block*, max_level + 1> free_blocks{};
-  std::bitset<S / sizeof(Block)> bitmap{};
-  std::array<uint8_t, S / sizeof(Block)> levels;
-
-  // for get_state()
-  std::unordered_map<uintptr_t, size_t> allocations;
+  std::conditional_t<C == Concurrency::PER_LEVEL, std::atomic<size_t>, size_t>
+      used;
+  size_t block_count;
+  size_t max_level;
+
+  // fixed by S, or enough for any capacity with dynamic_extent
+  static constexpr size_t level_count{
+      S == dynamic_extent ? sizeof(size_t) * 8
+                          : std::bit_width(S / sizeof(Block))};
+  static_assert(level_count <= sizeof(size_t) * 8,
+                "every level needs a bit in free_levels");
+  std::array<Block*, level_count> free_blocks{};
+  // bit i is set while free_blocks[i] is non-empty, read without a lock
+  std::conditional_t<C == Concurrency::PER_LEVEL, std::atomic<size_t>, size_t>
+      free_levels{};
+
+  // one per level, on separate lines so that threads allocating different
+  // sizes don't contend
+  struct alignas(cache_line_size) LevelLock {
+    std::mutex mutex;
+  };
+  [[no_unique_address]] std::conditional_t<C == Concurrency::PER_LEVEL,
+                                           std::array<LevelLock, level_count>,
+                                           Unlocked> locks;
+
+  // metadata is two bits per minimum block. blocks above the minimum are
+  // nodes of a tree in heap order, 1 .. block_count - 1, with a bit set
+  // while the node is split. that leaves block_count .. 2 * block_count - 1
+  // for a bit per minimum block, set while an allocation starts there.
+  // after the bits, the level of the block starting at each minimum block
+  // is packed into level_bits, so freeing it reads one word
+  static constexpr size_t level_bits{6};
+  static constexpr size_t levels_per_word{64 / level_bits};
+  static constexpr size_t bit_words(size_t blocks) noexcept {
+    return (2 * blocks + 63) / 64;
+  }
+  static constexpr size_t metadata_words(size_t blocks) noexcept {
+    return bit_words(blocks) +
+           (blocks + levels_per_word - 1) / levels_per_word;
+  }
+
+  // start of the blocks within an external buffer
+  static std::byte* align_buffer(std::byte* ptr, size_t size) noexcept;
+  // level of the smallest block that holds size bytes
+  static size_t level_for(size_t size) noexcept;
+  size_t level_of(size_t index) const noexcept;
+  void set_level(size_t index, size_t level) noexcept;
+  size_t split_bit(size_t index, size_t level) const noexcept;
+  size_t allocated_bit(size_t index) const noexcept;
+  bool test(size_t bit) const noexcept;
+  void set(size_t bit) noexcept;
+  void clear(size_t bit) noexcept;
+
+  // stays inline for BufferType::STACK, a side table otherwise
+  std::conditional_t<B == BufferType::STACK,
+                     std::array<uint64_t, metadata_words(S / sizeof(Block))>,
+                     uint64_t*>
+      metadata;
+
+  // for get_state(), compiled out unless Tracking::DEBUG
+  [[no_unique_address]] tracking_map_t<M, std::unordered_map<uintptr_t, size_t>>
+      allocations;
 };
 }  // namespace allocator
 
@@ -1,158 +1,514 @@
+#include <sys/mman.h>
+
 #include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <cstring>
+#include <mutex>
+#include <new>
 #include <ranges>
 #include <vector>
 
 #include "buddy_allocator.h"
 
 namespace allocator {
-template <size_t S, BufferType B>
-BuddyAllocator<S, B>::BuddyAllocator()
+template <size_t S, BufferType B, Tracking M, Decommit D, Concurrency C>
+BuddyAllocator<S, B, M, D, C>::BuddyAllocator()
   requires(S > 0 && (S & (S - 1)) == 0 && B == BufferType::HEAP)
-    : buffer(static_cast<std::byte*>(::operator new(S))),
+    : buffer(static_cast<std::byte*>(
+          ::operator new(S, std::align_val_t{base_alignment}))),
       data(buffer),
       capacity(S),
-      used(0) {
-  Block* block{reinterpret_cast<Block*>(data)};
-  block->next = nullptr;
-  block->previous = nullptr;
-  free_blocks[max_level] = block;
-  levels[0] = static_cast<uint8_t>(max_level);
+      used(0),
+      block_count(capacity / sizeof(Block)),
+      max_level(static_cast<size_t>(std::bit_width(block_count) - 1)),
+      metadata(new uint64_t[metadata_words(block_count)]) {
+  reset();
 }
 
-template <size_t S, BufferType B>
-BuddyAllocator<S, B>::BuddyAllocator()
+template <size_t S, BufferType B, Tracking M, Decommit D, Concurrency C>
+BuddyAllocator<S, B, M, D, C>::BuddyAllocator()
   requires(S > 0 && (S & (S - 1)) == 0 && B == BufferType::STACK)
     : buffer(std::array<std::byte, S>{}),
       data(buffer.data()),
       capacity(S),
-      used(0) {
-  Block* block{reinterpret_cast<Block*>(data)};
-  block->next = nullptr;
-  block->previous = nullptr;
-  free_blocks[max_level] = block;
-  levels[0] = static_cast<uint8_t>(max_level);
+      used(0),
+      block_count(capacity / sizeof(Block)),
+      max_level(static_cast<size_t>(std::bit_width(block_count) - 1)),
+      metadata() {
+  reset();
 }
 
-template <size_t S, BufferType B>
-BuddyAllocator<S, B>::BuddyAllocator(std::array<std::byte, S>& buf)
+template <size_t S, BufferType B, Tracking M, Decommit D, Concurrency C>
+BuddyAllocator<S, B, M, D, C>::BuddyAllocator(std::array<std::byte, S>& buf)
   requires(S > 0 && (S & (S - 1)) == 0 && B == BufferType::EXTERNAL)
-    : buffer(buf.data()), data(buf.data()), capacity(buf.size()), used(0) {
-  Block* block{reinterpret_cast<Block*>(data)};
-  block->next = nullptr;
-  block->previous = nullptr;
-  free_blocks[max_level] = block;
-  levels[0] = static_cast<uint8_t>(max_level);
+    : buffer(buf.data()),
+      data(align_buffer(buf.data(), buf.size())),
+      capacity(std::bit_floor(S - static_cast<size_t>(data - buf.data()))),
+      used(0),
+      block_count(capacity / sizeof(Block)),
+      max_level(static_cast<size_t>(std::bit_width(block_count) - 1)),
+      metadata(new uint64_t[metadata_words(block_count)]) {
+  assert(capacity >= sizeof(Block) && "capacity is too small");
+  reset();
+}
+
+template <size_t S, BufferType B, Tracking M, Decommit D, Concurrency C>
+BuddyAllocator<S, B, M, D, C>::BuddyAllocator(MapOptions options)
+  requires(S > 0 && (S & (S - 1)) == 0 && B == BufferType::MMAP)
+    : buffer(map_buffer(S, options)),
+      data(buffer),
+      capacity(S),
+      used(0),
+      block_count(capacity / sizeof(Block)),
+      max_level(static_cast<size_t>(std::bit_width(block_count) - 1)),
+      metadata(new uint64_t[metadata_words(block_count)]) {
+  reset();
 }
 
-template <size_t S, BufferType B>
-BuddyAllocator<S, B>::~BuddyAllocator() noexcept {
+template <size_t S, BufferType B, Tracking M, Decommit D, Concurrency C>
+BuddyAllocator<S, B, M, D, C>::BuddyAllocator(size_t size)
+  requires(S == dynamic_extent && B == BufferType::HEAP)
+    : capacity(std::bit_floor(size)),
+      used(0),
+      block_count(capacity / sizeof(Block)),
+      max_level(static_cast<size_t>(std::bit_width(block_count) - 1)),
+      metadata(new uint64_t[metadata_words(block_count)]) {
+  assert(capacity >= sizeof(Block) && "capacity is too small");
+
+  buffer = static_cast<std::byte*>(
+      ::operator new(capacity, std::align_val_t{base_alignment}));
+  data = buffer;
+  reset();
+}
+
+template <size_t S, BufferType B, Tracking M, Decommit D, Concurrency C>
+BuddyAllocator<S, B, M, D, C>::BuddyAllocator(std::span<std::byte> buf)
+  requires(S == dynamic_extent && B == BufferType::EXTERNAL)
+    : buffer(buf.data()),
+      data(align_buffer(buf.data(), buf.size())),
+      capacity(std::bit_floor(
+          buf.size() -
+          std::min<size_t>(static_cast<size_t>(data - buf.data()),
+                           buf.size()))),
+      used(0),
+      block_count(capacity / sizeof(Block)),
+      max_level(static_cast<size_t>(std::bit_width(block_count) - 1)),
+      metadata(new uint64_t[metadata_words(block_count)]) {
+  assert(capacity >= sizeof(Block) && "capacity is too small");
+  reset();
+}
+
+template <size_t S, BufferType B, Tracking M, Decommit D, Concurrency C>
+BuddyAllocator<S, B, M, D, C>::BuddyAllocator(size_t size, MapOptions options)
+  requires(S == dynamic_extent && B == BufferType::MMAP)
+    : capacity(std::bit_floor(size)),
+      used(0),
+      block_count(capacity / sizeof(Block)),
+      max_level(static_cast<size_t>(std::bit_width(block_count) - 1)),
+      metadata(new uint64_t[metadata_words(block_count)]) {
+  assert(capacity >= sizeof(Block) && "capacity is too small");
+
+  // mappings are aligned to huge_page_size, past any base_alignment
+  buffer = map_buffer(capacity, options);
+  data = buffer;
+  reset();
+}
+
+template <size_t S, BufferType B, Tracking M, Decommit D, Concurrency C>
+BuddyAllocator<S, B, M, D, C>::~BuddyAllocator() noexcept {
   if constexpr (B == BufferType::HEAP) {
-    ::operator delete(buffer);
+    ::operator delete(buffer, std::align_val_t{base_alignment});
+  } else if constexpr (B == BufferType::MMAP) {
+    unmap_buffer(buffer, capacity);
+  }
+
+  if constexpr (B != BufferType::STACK) {
+    delete[] metadata;
   }
 }
 
-template <size_t S, BufferType B>
-std::byte* BuddyAllocator<S, B>::allocate(size_t size) noexcept {
-  size_t effective_size{std::bit_ceil(std::max(size, sizeof(Block)))};
-  size_t level{
-      static_cast<size_t>(std::bit_width(effective_size / sizeof(Block)) - 1)};
+template <size_t S, BufferType B, Tracking M, Decommit D, Concurrency C>
+std::byte* BuddyAllocator<S, B, M, D, C>::allocate(size_t size) noexcept {
+  // blocks are naturally aligned to their size, relative to data
+  return allocate(size, 1);
+}
+
+template <size_t S, BufferType B, Tracking M, Decommit D, Concurrency C>
+std::byte* BuddyAllocator<S, B, M, D, C>::allocate(size_t size,
+                                                   size_t alignment) noexcept {
+  if (!is_valid_alignment(alignment)) {
+    return nullptr;
+  }
+
+  size_t level{level_for(size)};
 
   if (level > max_level) {
     return nullptr;
   }
 
-  size_t current{level};
-  while (free_blocks[current] == nullptr) {
+  // with data aligned, every block from this level up starts on an aligned
+  // offset. otherwise no level is, and blocks are only found by address
+  bool data_aligned{(reinterpret_cast<uintptr_t>(data) & (alignment - 1)) ==
+                    0};
+  size_t aligned_blocks{std::max(alignment, sizeof(Block)) / sizeof(Block)};
+  size_t aligned_level{
+      data_aligned ? static_cast<size_t>(std::bit_width(aligned_blocks) - 1)
+                   : max_level + 1};
+
+  Block* block{};
+  size_t current{std::max(level, aligned_level)};
+  while (current <= max_level) {
+    // lowest non-empty level at or above the requested one. with
+    // Concurrency::PER_LEVEL another thread may empty it before it is
+    // locked, and the search moves on up
+    size_t available{free_levels >> current};
+    if (available == 0) {
+      break;
+    }
+    current += static_cast<size_t>(std::countr_zero(available));
+
+    auto lock{lock_level(current)};
+    block = free_blocks[current];
+    if (block != nullptr) {
+      unlink(block, current);
+      claim(block, current, level);
+      break;
+    }
     ++current;
-    if (current > max_level) {
+  }
+
+  if (block == nullptr) {
+    if (aligned_level <= level) {
       return nullptr;
     }
-  }
 
-  Block* block{free_blocks[current]};
-  free_blocks[current] = block->next;
-  if (free_blocks[current]) {
-    free_blocks[current]->previous = nullptr;
+    // smaller blocks may still hold a block on an aligned address
+    block = find_aligned(level, aligned_level, alignment, current);
+    if (block == nullptr) {
+      return nullptr;
+    }
   }
 
+  // splitting keeps whichever half holds the first aligned address, the
+  // lower one unless the block was found by address. each half kept is
+  // marked before its buddy is pushed, so a thread freeing that buddy
+  // never sees it as free
+  std::byte* target{reinterpret_cast<std::byte*>(
+      align_forward(reinterpret_cast<uintptr_t>(block), alignment))};
   while (current > level) {
     --current;
+    Block* other{get_buddy(block, current)};
+    if (reinterpret_cast<std::byte*>(other) <= target) {
+      std::swap(block, other);
+    }
+    claim(block, current, level);
 
-    Block* buddy{get_buddy(block, current)};
-    size_t buddy_index{(reinterpret_cast<std::byte*>(buddy) - data) /
-                       sizeof(Block)};
-    levels[buddy_index] = static_cast<uint8_t>(current);
+    auto lock{lock_level(current)};
+    push(other, current);
+  }
+
+  set_level(static_cast<size_t>(reinterpret_cast<std::byte*>(block) - data) /
+                sizeof(Block),
+            level);
+  used += (size_t{1} << level) * sizeof(Block);
 
-    buddy->next = free_blocks[current];
-    buddy->previous = nullptr;
+  if constexpr (M == Tracking::DEBUG) {
+    uintptr_t ptr_offset{
+        static_cast<uintptr_t>(reinterpret_cast<std::byte*>(block) - data)};
+    allocations[ptr_offset] = (size_t{1} << level) * sizeof(Block);
+  }
 
-    if (free_blocks[current]) {
-      free_blocks[current]->previous = buddy;
-    }
-    free_blocks[current] = buddy;
+  return reinterpret_cast<std::byte*>(block);
+}
+
+template <size_t S, BufferType B, Tracking M, Decommit D, Concurrency C>
+void BuddyAllocator<S, B, M, D, C>::deallocate(std::byte* ptr) noexcept {
+  if (ptr == nullptr) {
+    return;
   }
 
+  assert(ptr >= data && ptr < data + capacity && "pointer is out of bounds");
+
+  Block* block{reinterpret_cast<Block*>(ptr)};
   size_t index{(reinterpret_cast<std::byte*>(block) - data) / sizeof(Block)};
-  bitmap.set(index);
-  levels[index] = static_cast<uint8_t>(level);
-  used += (size_t{1} << level) * sizeof(Block);
 
-  uintptr_t ptr_offset{
-      static_cast<uintptr_t>(reinterpret_cast<std::byte*>(block) - data)};
-  allocations[ptr_offset] = (size_t{1} << level) * sizeof(Block);
+  // the block's level is fixed while it is allocated, as neither it nor
+  // its parent can change until it is freed
+  size_t level{level_of(index)};
+  used -= (size_t{1} << level) * sizeof(Block);
 
-  return reinterpret_cast<std::byte*>(block);
+  release(block, level, allocated_bit(index));
+
+  if constexpr (M == Tracking::DEBUG) {
+    uintptr_t ptr_offset{static_cast<uintptr_t>(ptr - data)};
+    allocations.erase(ptr_offset);
+  }
 }
 
-template <size_t S, BufferType B>
-void BuddyAllocator<S, B>::deallocate(std::byte* ptr) noexcept {
+template <size_t S, BufferType B, Tracking M, Decommit D, Concurrency C>
+void BuddyAllocator<S, B, M, D, C>::deallocate(std::byte* ptr, size_t size,
+                                               size_t alignment) noexcept {
   if (ptr == nullptr) {
     return;
   }
 
   assert(ptr >= data && ptr < data + capacity && "pointer is out of bounds");
+  assert(is_valid_alignment(alignment) && "alignment is not a power of two");
 
   Block* block{reinterpret_cast<Block*>(ptr)};
   size_t index{(reinterpret_cast<std::byte*>(block) - data) / sizeof(Block)};
-  bitmap.reset(index);
 
-  size_t level{levels[index]};
+  // allocate() sizes the block for size alone, allocate_bulk() for
+  // max(size, alignment). the two agree unless alignment exceeds the block
+  // size alone, and only then is the level loaded
+  size_t level{level_for(size)};
+  if (alignment > (size_t{1} << level) * sizeof(Block)) {
+    level = level_of(index);
+  }
+  assert(level == level_of(index) && "size does not match the allocation");
   used -= (size_t{1} << level) * sizeof(Block);
 
-  while (level < max_level) {
-    Block* buddy{get_buddy(block, level)};
-    size_t buddy_index{(reinterpret_cast<std::byte*>(buddy) - data) /
-                       sizeof(Block)};
+  release(block, level, allocated_bit(index));
 
-    if (bitmap.test(buddy_index) || levels[buddy_index] != level) {
-      break;
+  if constexpr (M == Tracking::DEBUG) {
+    uintptr_t ptr_offset{static_cast<uintptr_t>(ptr - data)};
+    allocations.erase(ptr_offset);
+  }
+}
+
+template <size_t S, BufferType B, Tracking M, Decommit D, Concurrency C>
+std::byte* BuddyAllocator<S, B, M, D, C>::reallocate(
+    std::byte* ptr, size_t new_size, size_t alignment) noexcept {
+  if (ptr == nullptr) {
+    return allocate(new_size, alignment);
+  }
+
+  if (new_size > capacity || !is_valid_alignment(alignment)) {
+    return nullptr;
+  }
+
+  assert(ptr >= data && ptr < data + capacity && "pointer is out of bounds");
+
+  Block* block{reinterpret_cast<Block*>(ptr)};
+  size_t index{(reinterpret_cast<std::byte*>(block) - data) / sizeof(Block)};
+  size_t level{level_of(index)};
+  size_t new_level{level_for(new_size)};
+
+  // resizing in place keeps the address, so only a misaligned block moves
+  if ((reinterpret_cast<uintptr_t>(ptr) & (alignment - 1)) != 0) {
+    std::byte* moved{allocate(new_size, alignment)};
+    if (moved == nullptr) {
+      return nullptr;
     }
 
-    unlink(buddy, level);
+    std::memcpy(moved, ptr,
+                std::min(new_size, (size_t{1} << level) * sizeof(Block)));
+    deallocate(ptr);
+    return moved;
+  }
 
-    if (block > buddy) {
-      block = buddy;
+  if (new_level < level) {
+    // split as allocate() does, the lower half keeping the allocated bit
+    // and each upper half marked free once its sibling is split
+    set(split_bit(index, level));
+    for (size_t current{level}; current > new_level;) {
+      --current;
+      if (current > new_level) {
+        set(split_bit(index, current));
+      }
+
+      Block* buddy{get_buddy(block, current)};
+      auto lock{lock_level(current)};
+      push(buddy, current);
+
+      if constexpr (D == Decommit::INLINE) {
+        if ((sizeof(Block) << current) >= decommit_threshold) {
+          decommit(buddy, current);
+        }
+      }
     }
+  } else if (new_level > level) {
+    // only a lower half can grow, into upper halves that are free whole.
+    // each is taken under its level's lock, and nobody else reaches it once
+    // unlinked, as its buddy is this block
+    size_t current{level};
+    for (; current < new_level; ++current) {
+      Block* buddy{get_buddy(block, current)};
+      if (buddy < block) {
+        break;
+      }
 
-    ++level;
+      size_t buddy_index{(reinterpret_cast<std::byte*>(buddy) - data) /
+                         sizeof(Block)};
+      auto lock{lock_level(current)};
+      if ((current > 0 && test(split_bit(buddy_index, current))) ||
+          test(allocated_bit(buddy_index))) {
+        break;
+      }
+      unlink(buddy, current);
+    }
+
+    if (current < new_level) {
+      // the halves taken so far go back, to the lists they came from
+      while (current > level) {
+        --current;
+        auto lock{lock_level(current)};
+        push(get_buddy(block, current), current);
+      }
+
+      std::byte* moved{allocate(new_size, alignment)};
+      if (moved == nullptr) {
+        return nullptr;
+      }
+
+      std::memcpy(moved, ptr, (size_t{1} << level) * sizeof(Block));
+      deallocate(ptr);
+      return moved;
+    }
+
+    // the grown block reads as allocated throughout, as its first half
+    // keeps the allocated bit while the splits above it are undone
+    for (current = level + 1; current <= new_level; ++current) {
+      clear(split_bit(index, current));
+    }
+  } else {
+    return ptr;
   }
 
-  block->next = free_blocks[level];
-  block->previous = nullptr;
+  set_level(index, new_level);
+  used += ((size_t{1} << new_level) - (size_t{1} << level)) * sizeof(Block);
 
-  if (free_blocks[level]) {
-    free_blocks[level]->previous = block;
+  if constexpr (M == Tracking::DEBUG) {
+    allocations[static_cast<uintptr_t>(ptr - data)] =
+        (size_t{1} << new_level) * sizeof(Block);
   }
-  free_blocks[level] = block;
 
-  uintptr_t ptr_offset{static_cast<uintptr_t>(ptr - data)};
-  allocations.erase(ptr_offset);
+  return ptr;
+}
+
+template <size_t S, BufferType B, Tracking M, Decommit D, Concurrency C>
+size_t BuddyAllocator<S, B, M, D, C>::allocate_bulk(
+    size_t count, size_t size, size_t alignment,
+    std::span<std::byte*> out) noexcept {
+  if (!is_valid_alignment(alignment) ||
+      (reinterpret_cast<uintptr_t>(data) & (alignment - 1)) != 0) {
+    return 0;
+  }
+
+  size_t level{level_for(std::max(size, alignment))};
+
+  if (level > max_level) {
+    return 0;
+  }
+
+  out = out.first(std::min(count, out.size()));
+  size_t taken{};
+
+  // halves are only pushed once out is full, so until then the levels
+  // below current stay as empty as they were found
+  size_t current{level};
+  while (taken < out.size() && current <= max_level) {
+    size_t available{free_levels >> current};
+    if (available == 0) {
+      break;
+    }
+    current += static_cast<size_t>(std::countr_zero(available));
+
+    Block* block{};
+    {
+      auto lock{lock_level(current)};
+      block = free_blocks[current];
+      if (block != nullptr) {
+        unlink(block, current);
+        claim(block, current, level);
+      }
+    }
+
+    if (block == nullptr) {
+      ++current;
+      continue;
+    }
+
+    taken += split_bulk(block, current, level, out.subspan(taken));
+  }
+
+  used += taken * (size_t{1} << level) * sizeof(Block);
+
+  if constexpr (M == Tracking::DEBUG) {
+    for (std::byte* ptr : out.first(taken)) {
+      allocations[static_cast<uintptr_t>(ptr - data)] =
+          (size_t{1} << level) * sizeof(Block);
+    }
+  }
+
+  return taken;
+}
+
+template <size_t S, BufferType B, Tracking M, Decommit D, Concurrency C>
+void BuddyAllocator<S, B, M, D, C>::deallocate_bulk(
+    std::span<std::byte*> ptrs) noexcept {
+  // blocks not yet released, each waiting for its buddy to follow, with
+  // the bit that marks it allocated or split. both halves are this call's
+  // to free, so their bits are cleared without anyone else looking, and
+  // only the merged block is released
+  struct Run {
+    size_t index;
+    size_t level;
+    size_t bit;
+  };
+  std::array<Run, level_count> runs;
+  size_t depth{};
+  size_t freed{};
+
+  auto release_run{[this](const Run& run) {
+    release(reinterpret_cast<Block*>(data + run.index * sizeof(Block)),
+            run.level, run.bit);
+  }};
+
+  for (std::byte* ptr : ptrs) {
+    if (ptr == nullptr) {
+      continue;
+    }
+
+    assert(ptr >= data && ptr < data + capacity && "pointer is out of bounds");
+
+    size_t index{static_cast<size_t>(ptr - data) / sizeof(Block)};
+    size_t level{level_of(index)};
+    size_t bit{allocated_bit(index)};
+    freed += (size_t{1} << level) * sizeof(Block);
+
+    while (depth > 0 && runs[depth - 1].level == level &&
+           (runs[depth - 1].index ^ (size_t{1} << level)) == index) {
+      const Run& buddy{runs[--depth]};
+      clear(buddy.bit);
+      clear(bit);
+
+      index = std::min(buddy.index, index);
+      ++level;
+      bit = split_bit(index, level);
+    }
+
+    // only out of order frees fill it, which then merge through the lists
+    if (depth == runs.size()) {
+      release_run(runs[--depth]);
+    }
+    runs[depth++] = {index, level, bit};
+
+    if constexpr (M == Tracking::DEBUG) {
+      allocations.erase(static_cast<uintptr_t>(ptr - data));
+    }
+  }
+
+  used -= freed;
+  while (depth > 0) {
+    release_run(runs[--depth]);
+  }
 }
 
-template <size_t S, BufferType B>
-void BuddyAllocator<S, B>::reset() noexcept {
-  bitmap.reset();
+template <size_t S, BufferType B, Tracking M, Decommit D, Concurrency C>
+void BuddyAllocator<S, B, M, D, C>::reset() noexcept {
+  std::fill_n(&metadata[0], metadata_words(block_count), uint64_t{0});
   free_blocks = {};
   used = 0;
 
@@ -161,33 +517,83 @@ void BuddyAllocator<S, B>::reset() noexcept {
   block->previous = nullptr;
 
   free_blocks[max_level] = block;
-  levels[0] = static_cast<uint8_t>(max_level);
+  free_levels = size_t{1} << max_level;
+  set_level(0, max_level);
+
+  if constexpr (D == Decommit::INLINE) {
+    if (capacity >= decommit_threshold) {
+      decommit(block, max_level);
+    }
+  }
+
+  if constexpr (M == Tracking::DEBUG) {
+    allocations.clear();
+  }
 }
 
-template <size_t S, BufferType B>
-std::string BuddyAllocator<S, B>::get_state() const noexcept {
-  try {
-    std::vector<std::pair<uintptr_t, size_t>> pointers(allocations.begin(),
-                                                       allocations.end());
-    std::ranges::sort(pointers);
+template <size_t S, BufferType B, Tracking M, Decommit D, Concurrency C>
+size_t BuddyAllocator<S, B, M, D, C>::trim(size_t threshold) noexcept {
+  size_t released{};
+  for (size_t level{}; level <= max_level; ++level) {
+    if ((sizeof(Block) << level) < threshold) {
+      continue;
+    }
+
+    auto lock{lock_level(level)};
+    for (Block* block{free_blocks[level]}; block; block = block->next) {
+      released += decommit(block, level);
+    }
+  }
+
+  return released;
+}
 
+template <size_t S, BufferType B, Tracking M, Decommit D, Concurrency C>
+std::string BuddyAllocator<S, B, M, D, C>::get_state() const noexcept {
+  try {
     std::string blocks{};
-    for (const auto& [start, size] : pointers) {
-      if (!blocks.empty()) {
-        blocks += ",";
+
+    if constexpr (M == Tracking::DEBUG) {
+      std::vector<std::pair<uintptr_t, size_t>> pointers(allocations.begin(),
+                                                         allocations.end());
+      std::ranges::sort(pointers);
+
+      for (const auto& [start, size] : pointers) {
+        if (!blocks.empty()) {
+          blocks += ",";
+        }
+        blocks += "{\"ptr\":" + std::to_string(start) +
+                  ",\"offset\":" + std::to_string(start) +
+                  ",\"size\":" + std::to_string(size) +
+                  ",\"header\":0,\"status\":\"used\"}";
       }
-      blocks += "{\"ptr\":" + std::to_string(start) +
-                ",\"offset\":" + std::to_string(start) +
-                ",\"size\":" + std::to_string(size) +
-                ",\"header\":0,\"status\":\"used\"}";
-    }
 
-    for (size_t i{}; i <= max_level; ++i) {
-      Block* block{free_blocks[i]};
-      while (block != nullptr) {
-        size_t start{
-            static_cast<size_t>(reinterpret_cast<std::byte*>(block) - data)};
-        size_t size{sizeof(Block) << i};
+      for (size_t i{}; i <= max_level; ++i) {
+        Block* block{free_blocks[i]};
+        while (block != nullptr) {
+          size_t start{
+              static_cast<size_t>(reinterpret_cast<std::byte*>(block) - data)};
+          size_t size{sizeof(Block) << i};
+
+          if (!blocks.empty()) {
+            blocks += ",";
+          }
+
+          blocks += "{\"ptr\":" + std::to_string(start) +
+                    ",\"offset\":" + std::to_string(start) +
+                    ",\"size\":" + std::to_string(size) +
+                    ",\"header\":0,\"status\":\"free\"}";
+          block = block->next;
+        }
+      }
+    } else {
+      // every block, free or allocated, has its level stored, so blocks
+      // can be walked in order
+      size_t index{};
+      while (index < block_count) {
+        size_t level{level_of(index)};
+        size_t start{index * sizeof(Block)};
+        size_t size{sizeof(Block) << level};
 
         if (!blocks.empty()) {
           blocks += ",";
@@ -196,27 +602,31 @@ std::string BuddyAllocator<S, B>::get_state() const noexcept {
         blocks += "{\"ptr\":" + std::to_string(start) +
                   ",\"offset\":" + std::to_string(start) +
                   ",\"size\":" + std::to_string(size) +
-                  ",\"header\":0,\"status\":\"free\"}";
-        block = block->next;
+                  ",\"header\":0,\"status\":\"" +
+                  (test(allocated_bit(index)) ? "used" : "free") + "\"}";
+
+        index += size_t{1} << level;
       }
     }
 
-    return "{\"totalBytes\":" + std::to_string(S) + ",\"blocks\":[" + blocks +
-           "],\"metrics\":{\"used\":" + std::to_string(used) +
-           ",\"free\":" + std::to_string(S - used) + ",\"fragmentation\":0}}";
+    return "{\"totalBytes\":" + std::to_string(capacity) +
+           ",\"blocks\":[" + blocks +
+           "],\"metrics\":{\"used\":" + std::to_string(get_used()) +
+           ",\"free\":" + std::to_string(get_free()) +
+           ",\"fragmentation\":0}}";
 
   } catch (...) {
     return {};
   }
 }
 
-template <size_t S, BufferType B>
-size_t BuddyAllocator<S, B>::get_used() const noexcept {
+template <size_t S, BufferType B, Tracking M, Decommit D, Concurrency C>
+size_t BuddyAllocator<S, B, M, D, C>::get_used() const noexcept {
   return used;
 }
 
-template <size_t S, BufferType B>
-size_t BuddyAllocator<S, B>::get_free() const noexcept {
+template <size_t S, BufferType B, Tracking M, Decommit D, Concurrency C>
+size_t BuddyAllocator<S, B, M, D, C>::get_free() const noexcept {
   return capacity - used;
 }
 
@@ -224,26 +634,26 @@ size_t BuddyAllocator<S, B>::get_free() const noexcept {
 // type-safe helpers
 //////////////////////
 
-template <size_t S, BufferType B>
+template <size_t S, BufferType B, Tracking M, Decommit D, Concurrency C>
 template <typename T>
-T* BuddyAllocator<S, B>::allocate(size_t count) noexcept {
+T* BuddyAllocator<S, B, M, D, C>::allocate(size_t count) noexcept {
   if (count > SIZE_MAX / sizeof(T)) {
     return nullptr;
   }
 
-  return reinterpret_cast<T*>(allocate(sizeof(T) * count));
+  return reinterpret_cast<T*>(allocate(sizeof(T) * count, alignof(T)));
 }
 
-template <size_t S, BufferType B>
+template <size_t S, BufferType B, Tracking M, Decommit D, Concurrency C>
 template <typename T>
-void BuddyAllocator<S, B>::deallocate(T* ptr) noexcept {
+void BuddyAllocator<S, B, M, D, C>::deallocate(T* ptr) noexcept {
   deallocate(reinterpret_cast<std::byte*>(ptr));
 }
 
-template <size_t S, BufferType B>
+template <size_t S, BufferType B, Tracking M, Decommit D, Concurrency C>
 template <typename T, typename... Args>
-T* BuddyAllocator<S, B>::emplace(Args&&... args) {
-  std::byte* ptr{allocate(sizeof(T))};
+T* BuddyAllocator<S, B, M, D, C>::emplace(Args&&... args) {
+  std::byte* ptr{allocate(sizeof(T), alignof(T))};
   if (!ptr) {
     return nullptr;
   }
@@ -252,9 +662,9 @@ T* BuddyAllocator<S, B>::emplace(Args&&... args) {
                            std::forward<Args>(args)...);
 }
 
-template <size_t S, BufferType B>
+template <size_t S, BufferType B, Tracking M, Decommit D, Concurrency C>
 template <typename T>
-void BuddyAllocator<S, B>::destroy(T* ptr) noexcept {
+void BuddyAllocator<S, B, M, D, C>::destroy(T* ptr) noexcept {
   // asymmetric, does not deallocate (only reset does)
   if (ptr) {
     std::destroy_at(ptr);
@@ -265,20 +675,51 @@ void BuddyAllocator<S, B>::destroy(T* ptr) noexcept {
 // helpers
 //////////////////////
 
-template <size_t S, BufferType B>
-Block* BuddyAllocator<S, B>::get_buddy(Block* block,
+template <size_t S, BufferType B, Tracking M, Decommit D, Concurrency C>
+Block* BuddyAllocator<S, B, M, D, C>::get_buddy(Block* block,
                                        size_t level) const noexcept {
   size_t offset{(reinterpret_cast<std::byte*>(block) - data) ^
                 (size_t{1} << level) * sizeof(Block)};
   return reinterpret_cast<Block*>(data + offset);
 }
 
-template <size_t S, BufferType B>
-void BuddyAllocator<S, B>::unlink(Block* block, size_t level) noexcept {
+template <size_t S, BufferType B, Tracking M, Decommit D, Concurrency C>
+Block* BuddyAllocator<S, B, M, D, C>::find_aligned(size_t level,
+                                                   size_t aligned_level,
+                                                   size_t alignment,
+                                                   size_t& found) noexcept {
+  size_t block_size{sizeof(Block) << level};
+  for (size_t current{level};
+       current < aligned_level && current <= max_level; ++current) {
+    auto lock{lock_level(current)};
+    for (Block* block{free_blocks[current]}; block; block = block->next) {
+      // the first aligned address inside it, which must also start a block
+      // of level to be split down to
+      uintptr_t start{reinterpret_cast<uintptr_t>(block)};
+      uintptr_t target{align_forward(start, alignment)};
+      if (target + block_size <= start + (sizeof(Block) << current) &&
+          (target - reinterpret_cast<uintptr_t>(data)) % block_size == 0) {
+        unlink(block, current);
+        claim(block, current, level);
+        found = current;
+        return block;
+      }
+    }
+  }
+
+  return nullptr;
+}
+
+template <size_t S, BufferType B, Tracking M, Decommit D, Concurrency C>
+void BuddyAllocator<S, B, M, D, C>::unlink(Block* block,
+                                           size_t level) noexcept {
   if (block->previous) {
     block->previous->next = block->next;
   } else {
     free_blocks[level] = block->next;
+    if (free_blocks[level] == nullptr) {
+      free_levels &= ~(size_t{1} << level);
+    }
   }
 
   if (block->next) {
@@ -286,4 +727,242 @@ void BuddyAllocator<S, B>::unlink(Block* block, size_t level) noexcept {
   }
 }
 
+template <size_t S, BufferType B, Tracking M, Decommit D, Concurrency C>
+void BuddyAllocator<S, B, M, D, C>::push(Block* block, size_t level) noexcept {
+  set_level(static_cast<size_t>(reinterpret_cast<std::byte*>(block) - data) /
+                sizeof(Block),
+            level);
+  block->next = free_blocks[level];
+  block->previous = nullptr;
+
+  if (free_blocks[level]) {
+    free_blocks[level]->previous = block;
+  }
+  free_blocks[level] = block;
+  free_levels |= size_t{1} << level;
+}
+
+template <size_t S, BufferType B, Tracking M, Decommit D, Concurrency C>
+void BuddyAllocator<S, B, M, D, C>::release(Block* block, size_t level,
+                                            size_t bit) noexcept {
+  // a block's state only changes under the lock of its level, and levels
+  // are only ever locked in ascending order
+  auto lock{lock_level(level)};
+  clear(bit);
+
+  while (level < max_level) {
+    Block* buddy{get_buddy(block, level)};
+    size_t buddy_index{(reinterpret_cast<std::byte*>(buddy) - data) /
+                       sizeof(Block)};
+
+    // the parent is split, so the buddy is either split further, or a
+    // whole block that is allocated or free
+    if ((level > 0 && test(split_bit(buddy_index, level))) ||
+        test(allocated_bit(buddy_index))) {
+      break;
+    }
+
+    unlink(buddy, level);
+
+    if (block > buddy) {
+      block = buddy;
+    }
+
+    ++level;
+    lock = lock_level(level);
+    clear(split_bit(buddy_index, level));
+  }
+
+  push(block, level);
+
+  // before the lock is released, so no other thread has taken the block
+  if constexpr (D == Decommit::INLINE) {
+    if ((sizeof(Block) << level) >= decommit_threshold) {
+      decommit(block, level);
+    }
+  }
+}
+
+template <size_t S, BufferType B, Tracking M, Decommit D, Concurrency C>
+void BuddyAllocator<S, B, M, D, C>::claim(Block* block, size_t at,
+                                          size_t level) noexcept {
+  // split on the way down to the requested level, allocated once there
+  size_t index{(reinterpret_cast<std::byte*>(block) - data) / sizeof(Block)};
+  set(at > level ? split_bit(index, at) : allocated_bit(index));
+}
+
+template <size_t S, BufferType B, Tracking M, Decommit D, Concurrency C>
+size_t BuddyAllocator<S, B, M, D, C>::split_bulk(
+    Block* block, size_t at, size_t level,
+    std::span<std::byte*> out) noexcept {
+  size_t index{(reinterpret_cast<std::byte*>(block) - data) / sizeof(Block)};
+  size_t count{std::min(out.size(), size_t{1} << (at - level))};
+
+  // every node between the block and the ones taken is split. their bits
+  // are side by side on each level
+  for (size_t current{at}; current-- > level + 1;) {
+    size_t shift{current - level};
+    size_t first{split_bit(index, current)};
+    size_t nodes{(count + (size_t{1} << shift) - 1) >> shift};
+    for (size_t i{}; i < nodes; ++i) {
+      set(first + i);
+    }
+  }
+
+  for (size_t i{}; i < count; ++i) {
+    size_t taken{index + (i << level)};
+    set(allocated_bit(taken));
+    set_level(taken, level);
+    out[i] = data + taken * sizeof(Block);
+  }
+
+  // only then is the rest freed, as the largest blocks that fit. each is
+  // the upper half of a node on the way down to the last block taken
+  size_t next{count};
+  for (size_t current{level}; current < at; ++current) {
+    if ((next >> (current - level)) & 1) {
+      auto lock{lock_level(current)};
+      push(reinterpret_cast<Block*>(data + (index + (next << level)) *
+                                               sizeof(Block)),
+           current);
+      next += size_t{1} << (current - level);
+    }
+  }
+
+  return count;
+}
+
+template <size_t S, BufferType B, Tracking M, Decommit D, Concurrency C>
+auto BuddyAllocator<S, B, M, D, C>::lock_level(size_t level) noexcept {
+  if constexpr (C == Concurrency::PER_LEVEL) {
+    return std::unique_lock{locks[level].mutex};
+  } else {
+    return Unlocked{};
+  }
+}
+
+template <size_t S, BufferType B, Tracking M, Decommit D, Concurrency C>
+size_t BuddyAllocator<S, B, M, D, C>::decommit(Block* block,
+                                               size_t level) noexcept {
+  // the page holding the links stays resident, so the free lists can be
+  // walked without faulting released pages back in
+  uintptr_t start{reinterpret_cast<uintptr_t>(block)};
+  uintptr_t first{align_forward(start + sizeof(Block), page_size)};
+  uintptr_t last{(start + (sizeof(Block) << level)) & ~(page_size - 1)};
+  if (last <= first) {
+    return 0;
+  }
+
+  // MADV_DONTNEED drops the pages at once, where MADV_FREE would leave
+  // them resident until the system is short of memory
+  if (::madvise(reinterpret_cast<void*>(first), last - first,
+                MADV_DONTNEED) != 0) {
+    return 0;
+  }
+  return last - first;
+}
+
+template <size_t S, BufferType B, Tracking M, Decommit D, Concurrency C>
+std::byte* BuddyAllocator<S, B, M, D, C>::align_buffer(std::byte* ptr,
+                                                       size_t size) noexcept {
+  // blocks need alignof(std::max_align_t), even if half the buffer goes.
+  // past that, as far as base_alignment while no capacity is lost
+  uintptr_t start{reinterpret_cast<uintptr_t>(ptr)};
+  uintptr_t aligned{align_forward(start, alignof(std::max_align_t))};
+  size_t kept{std::bit_floor(size - std::min<size_t>(aligned - start, size))};
+
+  for (size_t alignment{alignof(std::max_align_t) * 2};
+       alignment <= base_alignment; alignment *= 2) {
+    uintptr_t next{align_forward(start, alignment)};
+    if (next - start > size || std::bit_floor(size - (next - start)) < kept) {
+      break;
+    }
+    aligned = next;
+  }
+
+  return reinterpret_cast<std::byte*>(aligned);
+}
+
+template <size_t S, BufferType B, Tracking M, Decommit D, Concurrency C>
+size_t BuddyAllocator<S, B, M, D, C>::level_for(size_t size) noexcept {
+  size_t effective_size{std::bit_ceil(std::max(size, sizeof(Block)))};
+  return static_cast<size_t>(
+      std::bit_width(effective_size / sizeof(Block)) - 1);
+}
+
+template <size_t S, BufferType B, Tracking M, Decommit D, Concurrency C>
+size_t BuddyAllocator<S, B, M, D, C>::level_of(size_t index) const noexcept {
+  size_t word{bit_words(block_count) + index / levels_per_word};
+  size_t shift{index % levels_per_word * level_bits};
+  uint64_t bits{};
+  if constexpr (C == Concurrency::PER_LEVEL) {
+    std::atomic_ref ref{const_cast<uint64_t&>(metadata[word])};
+    bits = ref.load(std::memory_order_relaxed);
+  } else {
+    bits = metadata[word];
+  }
+
+  return (bits >> shift) & ((uint64_t{1} << level_bits) - 1);
+}
+
+template <size_t S, BufferType B, Tracking M, Decommit D, Concurrency C>
+void BuddyAllocator<S, B, M, D, C>::set_level(size_t index,
+                                              size_t level) noexcept {
+  // only whoever holds the block writes its field, so clearing and setting
+  // it apart is safe while other fields of the word change
+  size_t word{bit_words(block_count) + index / levels_per_word};
+  size_t shift{index % levels_per_word * level_bits};
+  uint64_t mask{((uint64_t{1} << level_bits) - 1) << shift};
+  if constexpr (C == Concurrency::PER_LEVEL) {
+    std::atomic_ref ref{metadata[word]};
+    ref.fetch_and(~mask, std::memory_order_relaxed);
+    ref.fetch_or(uint64_t{level} << shift, std::memory_order_relaxed);
+  } else {
+    metadata[word] = (metadata[word] & ~mask) | (uint64_t{level} << shift);
+  }
+}
+
+template <size_t S, BufferType B, Tracking M, Decommit D, Concurrency C>
+size_t BuddyAllocator<S, B, M, D, C>::split_bit(size_t index,
+                                                size_t level) const noexcept {
+  return (block_count >> level) + (index >> level);
+}
+
+template <size_t S, BufferType B, Tracking M, Decommit D, Concurrency C>
+size_t BuddyAllocator<S, B, M, D, C>::allocated_bit(
+    size_t index) const noexcept {
+  return block_count + index;
+}
+
+template <size_t S, BufferType B, Tracking M, Decommit D, Concurrency C>
+bool BuddyAllocator<S, B, M, D, C>::test(size_t bit) const noexcept {
+  if constexpr (C == Concurrency::PER_LEVEL) {
+    // a word holds the bits of neighbouring blocks on other levels
+    std::atomic_ref word{const_cast<uint64_t&>(metadata[bit / 64])};
+    return (word.load(std::memory_order_relaxed) >> (bit % 64)) & 1;
+  } else {
+    return (metadata[bit / 64] >> (bit % 64)) & 1;
+  }
+}
+
+template <size_t S, BufferType B, Tracking M, Decommit D, Concurrency C>
+void BuddyAllocator<S, B, M, D, C>::set(size_t bit) noexcept {
+  if constexpr (C == Concurrency::PER_LEVEL) {
+    std::atomic_ref word{metadata[bit / 64]};
+    word.fetch_or(uint64_t{1} << (bit % 64), std::memory_order_relaxed);
+  } else {
+    metadata[bit / 64] |= uint64_t{1} << (bit % 64);
+  }
+}
+
+template <size_t S, BufferType B, Tracking M, Decommit D, Concurrency C>
+void BuddyAllocator<S, B, M, D, C>::clear(size_t bit) noexcept {
+  if constexpr (C == Concurrency::PER_LEVEL) {
+    std::atomic_ref word{metadata[bit / 64]};
+    word.fetch_and(~(uint64_t{1} << (bit % 64)), std::memory_order_relaxed);
+  } else {
+    metadata[bit / 64] &= ~(uint64_t{1} << (bit % 64));
+  }
+}
+
 }  // namespace allocator
\ No newline at end of file
@@ -1,17 +1,63 @@
 #pragma once
 
 #include <cstddef>
+#include <span>
+#include <string_view>
+#include <type_traits>
 
 namespace allocator {
 
-enum class BufferType { HEAP, STACK, EXTERNAL };
+// BufferType::MMAP maps the buffer directly from the OS, see mmap_buffer.h
+enum class BufferType { HEAP, STACK, EXTERNAL, MMAP };
 enum class FitStrategy { FIRST, BEST };
 
+// what a GrowableLinearAllocator keeps across reset(), either just its
+// largest chunk or enough chunks to cover the peak of the cycle just ended
+enum class Retention { LARGEST, HIGH_WATER };
+
+// whether a BuddyAllocator returns the pages of large free blocks to the OS
+// as they coalesce in deallocate(), or only on an explicit trim()
+enum class Decommit { NONE, INLINE };
+
+// whether an allocator can be shared between threads. PER_LEVEL gives a
+// BuddyAllocator a lock per level of free lists and atomic updates to the
+// bits describing its blocks. OWNER lets any thread free into a
+// FreeListAllocator or PoolAllocator that one thread allocates from, see
+// remote_free_list.h
+enum class Concurrency { NONE, PER_LEVEL, OWNER };
+
+// how a ShardedAllocator picks the shard a thread allocates from, the CPU
+// it is running on or a slot handed to each thread on its first allocation
+enum class Affinity { CPU, THREAD };
+
+// Tracking::DEBUG keeps a per-allocation map for get_state(),
+// Tracking::NONE compiles it out and get_state() walks the buffer instead
+enum class Tracking { NONE, DEBUG };
+
+// stand-in for the allocation map when tracking is compiled out
+struct Untracked {};
+
+template <Tracking T, typename Map>
+using tracking_map_t =
+    std::conditional_t<T == Tracking::DEBUG, Map, Untracked>;
+
+// passed as the capacity to choose it at construction instead, from a byte
+// count or a std::span<std::byte>
+inline constexpr size_t dynamic_extent{std::dynamic_extent};
+
+// smallest page on the platforms we target, the most any buffer needs to
+// be aligned to for SIMD or DMA use
+inline constexpr size_t page_size{4096};
+
+// the unit of false sharing on the platforms we target, state written by
+// different threads is kept on separate lines
+inline constexpr size_t cache_line_size{64};
+
 inline bool is_valid_alignment(size_t alignment) {
   return alignment > 0 && (alignment & (alignment - 1)) == 0;
 }
 
-inline size_t align_forward(size_t offset, size_t alignment) {
+constexpr size_t align_forward(size_t offset, size_t alignment) {
   size_t remainder{offset % alignment};
   if (remainder == 0) {
     return offset;
@@ -34,5 +80,14 @@ struct TrackedObj {
   TrackedObj(int v) : value(v) {}
   ~TrackedObj() { ++destructor_calls; }
 };
+
+inline size_t count_occurrences(std::string_view text, std::string_view token) {
+  size_t count{};
+  for (size_t pos{text.find(token)}; pos != std::string_view::npos;
+       pos = text.find(token, pos + token.size())) {
+    ++count;
+  }
+  return count;
+}
 }
 }  // namespace allocator
\ No newline at end of file
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <span>
+#include <string>
+#include <type_traits>
+
+#include "common.h"
+#include "mmap_buffer.h"
+
+namespace allocator {
+
+// a LinearAllocator that many threads can bump at once, with a single
+// atomic offset. allocate() is lock-free, while reset() and rewind() must
+// not run alongside it
+template <size_t S, BufferType B = BufferType::HEAP>
+class ConcurrentLinearAllocator {
+ public:
+  static constexpr size_t extent = S;
+  static constexpr BufferType buffer_type = B;
+
+  // allocations are padded to this, so that up to it a fetch-add suffices
+  static constexpr size_t granularity{alignof(std::max_align_t)};
+
+  // position to rewind() to, which releases everything allocated after it
+  struct Marker {
+    size_t offset;
+  };
+
+  explicit ConcurrentLinearAllocator()
+    requires(S > 0 && S != dynamic_extent && B == BufferType::HEAP);
+  explicit ConcurrentLinearAllocator()
+    requires(S > 0 && S != dynamic_extent && B == BufferType::STACK);
+  explicit ConcurrentLinearAllocator(std::array<std::byte, S>& buf)
+    requires(S > 0 && S != dynamic_extent && B == BufferType::EXTERNAL);
+  explicit ConcurrentLinearAllocator(MapOptions options = {})
+    requires(S > 0 && S != dynamic_extent && B == BufferType::MMAP);
+
+  // capacity chosen at construction, with S = dynamic_extent
+  explicit ConcurrentLinearAllocator(size_t size)
+    requires(S == dynamic_extent && B == BufferType::HEAP);
+  explicit ConcurrentLinearAllocator(std::span<std::byte> buf)
+    requires(S == dynamic_extent && B == BufferType::EXTERNAL);
+  explicit ConcurrentLinearAllocator(size_t size, MapOptions options = {})
+    requires(S == dynamic_extent && B == BufferType::MMAP);
+  ~ConcurrentLinearAllocator() noexcept;
+
+  ConcurrentLinearAllocator(const ConcurrentLinearAllocator&) = delete;
+  ConcurrentLinearAllocator& operator=(const ConcurrentLinearAllocator&) =
+      delete;
+
+  ConcurrentLinearAllocator(ConcurrentLinearAllocator&&) = delete;
+  ConcurrentLinearAllocator& operator=(ConcurrentLinearAllocator&&) = delete;
+
+  // thread-safe
+  [[nodiscard]] std::byte* allocate(size_t size, size_t alignment) noexcept;
+
+  void reset() noexcept;
+
+  // markers are taken and rewound between phases, while no thread is
+  // allocating, and must be rewound innermost first
+  Marker get_marker() const noexcept;
+  void rewind(Marker marker) noexcept;
+
+  std::string get_state() const noexcept;
+
+  // exact once allocating threads are joined, a snapshot before that
+  size_t get_used() const noexcept;
+  size_t get_free() const noexcept;
+
+  //////////////////////
+  // type-safe helpers
+  //////////////////////
+  template <typename T>
+  [[nodiscard]] T* allocate(size_t count = 1) noexcept;
+
+  template <typename T, typename... Args>
+  [[nodiscard]] T* emplace(Args&&... args);
+
+  template <typename T>
+  void destroy(T* ptr) noexcept;
+
+ private:
+  std::byte* allocate_aligned(size_t size, size_t alignment) noexcept;
+
+  alignas(std::max_align_t)
+      std::conditional_t<B == BufferType::STACK, std::array<std::byte, S>,
+                         std::byte*> buffer;
+  std::byte* data;
+  size_t capacity;
+
+  // always a multiple of granularity. may pass capacity after a failed
+  // fetch-add, which every reader clamps. there is no previous_offset, as
+  // the last allocation is not well defined across threads, and no
+  // allocation map for get_state()
+  alignas(cache_line_size) std::atomic<size_t> offset;
+};
+}  // namespace allocator
+
+#include "concurrent_linear_allocator.inl"
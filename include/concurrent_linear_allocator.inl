@@ -0,0 +1,230 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <memory>
+#include <utility>
+
+#include "concurrent_linear_allocator.h"
+
+namespace allocator {
+template <size_t S, BufferType B>
+ConcurrentLinearAllocator<S, B>::ConcurrentLinearAllocator()
+  requires(S > 0 && S != dynamic_extent && B == BufferType::HEAP)
+    : buffer(static_cast<std::byte*>(::operator new(S))),
+      data(buffer),
+      capacity(S),
+      offset(0) {}
+
+template <size_t S, BufferType B>
+ConcurrentLinearAllocator<S, B>::ConcurrentLinearAllocator()
+  requires(S > 0 && S != dynamic_extent && B == BufferType::STACK)
+    : buffer(std::array<std::byte, S>{}),
+      data(buffer.data()),
+      capacity(S),
+      offset(0) {}
+
+template <size_t S, BufferType B>
+ConcurrentLinearAllocator<S, B>::ConcurrentLinearAllocator(
+    std::array<std::byte, S>& buf)
+  requires(S > 0 && S != dynamic_extent && B == BufferType::EXTERNAL)
+    : buffer(buf.data()), offset(0) {
+  // ensures buffer pointer is aligned
+  data = reinterpret_cast<std::byte*>(align_forward(
+      reinterpret_cast<size_t>(buf.data()), granularity));
+  capacity = S - std::min<size_t>(data - buf.data(), S);
+}
+
+template <size_t S, BufferType B>
+ConcurrentLinearAllocator<S, B>::ConcurrentLinearAllocator(MapOptions options)
+  requires(S > 0 && S != dynamic_extent && B == BufferType::MMAP)
+    : buffer(map_buffer(S, options)), data(buffer), capacity(S), offset(0) {}
+
+template <size_t S, BufferType B>
+ConcurrentLinearAllocator<S, B>::ConcurrentLinearAllocator(size_t size)
+  requires(S == dynamic_extent && B == BufferType::HEAP)
+    : buffer(static_cast<std::byte*>(::operator new(size))),
+      data(buffer),
+      capacity(size),
+      offset(0) {}
+
+template <size_t S, BufferType B>
+ConcurrentLinearAllocator<S, B>::ConcurrentLinearAllocator(
+    std::span<std::byte> buf)
+  requires(S == dynamic_extent && B == BufferType::EXTERNAL)
+    : buffer(buf.data()), offset(0) {
+  // ensures buffer pointer is aligned
+  data = reinterpret_cast<std::byte*>(align_forward(
+      reinterpret_cast<size_t>(buf.data()), granularity));
+  capacity = buf.size() - std::min<size_t>(data - buf.data(), buf.size());
+}
+
+template <size_t S, BufferType B>
+ConcurrentLinearAllocator<S, B>::ConcurrentLinearAllocator(size_t size,
+                                                           MapOptions options)
+  requires(S == dynamic_extent && B == BufferType::MMAP)
+    : buffer(map_buffer(size, options)),
+      data(buffer),
+      capacity(size),
+      offset(0) {}
+
+template <size_t S, BufferType B>
+ConcurrentLinearAllocator<S, B>::~ConcurrentLinearAllocator() noexcept {
+  if constexpr (B == BufferType::HEAP) {
+    ::operator delete(buffer);
+  } else if constexpr (B == BufferType::MMAP) {
+    unmap_buffer(buffer, capacity);
+  }
+}
+
+template <size_t S, BufferType B>
+std::byte* ConcurrentLinearAllocator<S, B>::allocate(
+    size_t size, size_t alignment) noexcept {
+  if (!is_valid_alignment(alignment)) {
+    return nullptr;
+  }
+  if (alignment > granularity) {
+    return allocate_aligned(size, alignment);
+  }
+
+  // data and every offset are aligned to granularity, so claiming the
+  // padded size is enough and needs no retry under contention
+  if (size > capacity) {  // also guards the padding against overflow
+    return nullptr;
+  }
+  size_t padded{align_forward(size, granularity)};
+  size_t start{offset.fetch_add(padded, std::memory_order_relaxed)};
+
+  if (start > capacity || padded > capacity - start) {
+    // gives the tail back if no other thread has claimed past it since,
+    // so one oversized request doesn't exhaust the arena for the rest
+    size_t claimed{start + padded};
+    offset.compare_exchange_strong(claimed, start, std::memory_order_relaxed);
+    return nullptr;
+  }
+  return data + start;
+}
+
+template <size_t S, BufferType B>
+void ConcurrentLinearAllocator<S, B>::reset() noexcept {
+  offset.store(0, std::memory_order_relaxed);
+}
+
+template <size_t S, BufferType B>
+typename ConcurrentLinearAllocator<S, B>::Marker
+ConcurrentLinearAllocator<S, B>::get_marker() const noexcept {
+  return {get_used()};
+}
+
+template <size_t S, BufferType B>
+void ConcurrentLinearAllocator<S, B>::rewind(Marker marker) noexcept {
+  assert(marker.offset <= offset.load(std::memory_order_relaxed) &&
+         "marker is past the current offset");
+  offset.store(marker.offset, std::memory_order_relaxed);
+}
+
+template <size_t S, BufferType B>
+std::string ConcurrentLinearAllocator<S, B>::get_state() const noexcept {
+  try {
+    size_t used{get_used()};
+    std::string blocks{};
+
+    // individual allocations are not recoverable without headers,
+    // so the bumped region is reported as a single used block
+    if (used > 0) {
+      blocks += "{\"ptr\":0,\"offset\":0,\"size\":" + std::to_string(used) +
+                ",\"header\":0,\"status\":\"used\"}";
+    }
+
+    if (used < capacity) {
+      if (!blocks.empty()) {
+        blocks += ",";
+      }
+      blocks += "{\"ptr\":null,\"offset\":" + std::to_string(used) +
+                ",\"size\":" + std::to_string(capacity - used) +
+                ",\"header\":0,\"status\":\"free\"}";
+    }
+
+    return "{\"totalBytes\":" + std::to_string(capacity) +
+           ",\"blocks\":[" + blocks +
+           "],\"metrics\":{\"used\":" + std::to_string(used) +
+           ",\"free\":" + std::to_string(capacity - used) +
+           ",\"fragmentation\":0}}";
+
+  } catch (...) {
+    return {};
+  }
+}
+
+template <size_t S, BufferType B>
+size_t ConcurrentLinearAllocator<S, B>::get_used() const noexcept {
+  return std::min(offset.load(std::memory_order_relaxed), capacity);
+}
+
+template <size_t S, BufferType B>
+size_t ConcurrentLinearAllocator<S, B>::get_free() const noexcept {
+  return capacity - get_used();
+}
+
+template <size_t S, BufferType B>
+std::byte* ConcurrentLinearAllocator<S, B>::allocate_aligned(
+    size_t size, size_t alignment) noexcept {
+  // the padding depends on where the allocation starts, so the offset is
+  // claimed with a compare-exchange against the value it was computed from
+  uintptr_t base{reinterpret_cast<uintptr_t>(data)};
+  size_t current{offset.load(std::memory_order_relaxed)};
+  size_t aligned{};
+
+  do {
+    aligned = align_forward(base + current, alignment) - base;
+    if (aligned < current || aligned > capacity ||
+        size > capacity - aligned) {
+      return nullptr;
+    }
+  } while (!offset.compare_exchange_weak(
+      current, align_forward(aligned + size, granularity),
+      std::memory_order_relaxed));
+
+  return data + aligned;
+}
+
+//////////////////////
+// type-safe helpers
+//////////////////////
+
+template <size_t S, BufferType B>
+template <typename T>
+T* ConcurrentLinearAllocator<S, B>::allocate(size_t count) noexcept {
+  if (count > SIZE_MAX / sizeof(T)) {  // check uint overflow
+    return nullptr;
+  }
+
+  size_t size{sizeof(T) * count};
+  size_t alignment{alignof(T)};
+  return reinterpret_cast<T*>(allocate(size, alignment));
+}
+
+template <size_t S, BufferType B>
+template <typename T, typename... Args>
+T* ConcurrentLinearAllocator<S, B>::emplace(Args&&... args) {
+  size_t size{sizeof(T)};
+  size_t alignment{alignof(T)};
+
+  std::byte* ptr{allocate(size, alignment)};
+  if (!ptr) {
+    return nullptr;
+  }
+
+  return std::construct_at(reinterpret_cast<T*>(ptr),
+                           std::forward<Args>(args)...);
+}
+
+template <size_t S, BufferType B>
+template <typename T>
+void ConcurrentLinearAllocator<S, B>::destroy(T* ptr) noexcept {
+  // asymmetric, does not deallocate (only reset does)
+  if (ptr) {
+    std::destroy_at(ptr);
+  }
+}
+}  // namespace allocator
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <span>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+
+#include "common.h"
+#include "mmap_buffer.h"
+
+namespace allocator {
+
+// bumps forward from the front and backward from the back of one buffer,
+// so two lifetimes share its capacity and each end is reset on its own
+template <size_t S, BufferType B = BufferType::HEAP,
+          Tracking M = Tracking::NONE>
+class DoubleEndedLinearAllocator {
+ public:
+  static constexpr size_t extent = S;
+  static constexpr BufferType buffer_type = B;
+  static constexpr Tracking tracking = M;
+
+  explicit DoubleEndedLinearAllocator()
+    requires(S > 0 && S != dynamic_extent && B == BufferType::HEAP);
+  explicit DoubleEndedLinearAllocator()
+    requires(S > 0 && S != dynamic_extent && B == BufferType::STACK);
+  explicit DoubleEndedLinearAllocator(std::array<std::byte, S>& buf)
+    requires(S > 0 && S != dynamic_extent && B == BufferType::EXTERNAL);
+  explicit DoubleEndedLinearAllocator(MapOptions options = {})
+    requires(S > 0 && S != dynamic_extent && B == BufferType::MMAP);
+
+  // capacity chosen at construction, with S = dynamic_extent
+  explicit DoubleEndedLinearAllocator(size_t size)
+    requires(S == dynamic_extent && B == BufferType::HEAP);
+  explicit DoubleEndedLinearAllocator(std::span<std::byte> buf)
+    requires(S == dynamic_extent && B == BufferType::EXTERNAL);
+  explicit DoubleEndedLinearAllocator(size_t size, MapOptions options = {})
+    requires(S == dynamic_extent && B == BufferType::MMAP);
+  ~DoubleEndedLinearAllocator() noexcept;
+
+  DoubleEndedLinearAllocator(const DoubleEndedLinearAllocator&) = delete;
+  DoubleEndedLinearAllocator& operator=(const DoubleEndedLinearAllocator&) =
+      delete;
+
+  DoubleEndedLinearAllocator(DoubleEndedLinearAllocator&&) = delete;
+  DoubleEndedLinearAllocator& operator=(DoubleEndedLinearAllocator&&) =
+      delete;
+
+  [[nodiscard]] std::byte* allocate_front(size_t size,
+                                          size_t alignment) noexcept;
+  [[nodiscard]] std::byte* allocate_back(size_t size,
+                                         size_t alignment) noexcept;
+
+  // the front grows into free space in place, the back would have to move
+  [[nodiscard]] std::byte* resize_last_front(std::byte* previous_memory,
+                                             size_t new_size,
+                                             size_t alignment) noexcept;
+
+  void reset_front() noexcept;
+  void reset_back() noexcept;
+  void reset() noexcept;
+
+  std::string get_state() const noexcept;
+
+  size_t get_used() const noexcept;
+  size_t get_free() const noexcept;
+
+  //////////////////////
+  // type-safe helpers
+  //////////////////////
+  template <typename T>
+  [[nodiscard]] T* allocate_front(size_t count = 1) noexcept;
+
+  template <typename T>
+  [[nodiscard]] T* allocate_back(size_t count = 1) noexcept;
+
+  template <typename T, typename... Args>
+  [[nodiscard]] T* emplace_front(Args&&... args);
+
+  template <typename T, typename... Args>
+  [[nodiscard]] T* emplace_back(Args&&... args);
+
+  template <typename T>
+  void destroy(T* ptr) noexcept;
+
+ private:
+  std::conditional_t<B == BufferType::STACK, std::array<std::byte, S>,
+                     std::byte*>
+      buffer;
+  std::byte* data;
+  size_t capacity;
+
+  // the front is used below front_offset, the back from back_offset on
+  size_t front_offset;
+  size_t previous_front_offset;
+  size_t back_offset;
+
+  // for get_state(), compiled out unless Tracking::DEBUG
+  [[no_unique_address]] tracking_map_t<M, std::unordered_map<uintptr_t, size_t>>
+      allocations;
+};
+}  // namespace allocator
+
+#include "double_ended_linear_allocator.inl"
@@ -0,0 +1,337 @@
+#pragma once
+
+#include <algorithm>
+#include <memory>
+#include <ranges>
+#include <utility>
+#include <vector>
+
+#include "double_ended_linear_allocator.h"
+
+namespace allocator {
+template <size_t S, BufferType B, Tracking M>
+DoubleEndedLinearAllocator<S, B, M>::DoubleEndedLinearAllocator()
+  requires(S > 0 && S != dynamic_extent && B == BufferType::HEAP)
+    : buffer(static_cast<std::byte*>(::operator new(S))),
+      data(buffer),
+      capacity(S),
+      front_offset(0),
+      previous_front_offset(0),
+      back_offset(S) {}
+
+template <size_t S, BufferType B, Tracking M>
+DoubleEndedLinearAllocator<S, B, M>::DoubleEndedLinearAllocator()
+  requires(S > 0 && S != dynamic_extent && B == BufferType::STACK)
+    : buffer(std::array<std::byte, S>{}),
+      data(buffer.data()),
+      capacity(S),
+      front_offset(0),
+      previous_front_offset(0),
+      back_offset(S) {}
+
+template <size_t S, BufferType B, Tracking M>
+DoubleEndedLinearAllocator<S, B, M>::DoubleEndedLinearAllocator(
+    std::array<std::byte, S>& buf)
+  requires(S > 0 && S != dynamic_extent && B == BufferType::EXTERNAL)
+    : buffer(buf.data()), front_offset(0), previous_front_offset(0) {
+  // ensures buffer pointer is aligned
+  data = reinterpret_cast<std::byte*>(align_forward(
+      reinterpret_cast<size_t>(buf.data()), alignof(std::max_align_t)));
+  capacity = S - (data - buf.data());
+  back_offset = capacity;
+}
+
+template <size_t S, BufferType B, Tracking M>
+DoubleEndedLinearAllocator<S, B, M>::DoubleEndedLinearAllocator(
+    MapOptions options)
+  requires(S > 0 && S != dynamic_extent && B == BufferType::MMAP)
+    : buffer(map_buffer(S, options)),
+      data(buffer),
+      capacity(S),
+      front_offset(0),
+      previous_front_offset(0),
+      back_offset(S) {}
+
+template <size_t S, BufferType B, Tracking M>
+DoubleEndedLinearAllocator<S, B, M>::DoubleEndedLinearAllocator(size_t size)
+  requires(S == dynamic_extent && B == BufferType::HEAP)
+    : buffer(static_cast<std::byte*>(::operator new(size))),
+      data(buffer),
+      capacity(size),
+      front_offset(0),
+      previous_front_offset(0),
+      back_offset(size) {}
+
+template <size_t S, BufferType B, Tracking M>
+DoubleEndedLinearAllocator<S, B, M>::DoubleEndedLinearAllocator(
+    std::span<std::byte> buf)
+  requires(S == dynamic_extent && B == BufferType::EXTERNAL)
+    : buffer(buf.data()), front_offset(0), previous_front_offset(0) {
+  // ensures buffer pointer is aligned
+  data = reinterpret_cast<std::byte*>(align_forward(
+      reinterpret_cast<size_t>(buf.data()), alignof(std::max_align_t)));
+  capacity = buf.size() - std::min<size_t>(data - buf.data(), buf.size());
+  back_offset = capacity;
+}
+
+template <size_t S, BufferType B, Tracking M>
+DoubleEndedLinearAllocator<S, B, M>::DoubleEndedLinearAllocator(
+    size_t size, MapOptions options)
+  requires(S == dynamic_extent && B == BufferType::MMAP)
+    : buffer(map_buffer(size, options)),
+      data(buffer),
+      capacity(size),
+      front_offset(0),
+      previous_front_offset(0),
+      back_offset(size) {}
+
+template <size_t S, BufferType B, Tracking M>
+DoubleEndedLinearAllocator<S, B, M>::~DoubleEndedLinearAllocator() noexcept {
+  if constexpr (B == BufferType::HEAP) {
+    ::operator delete(buffer);
+  } else if constexpr (B == BufferType::MMAP) {
+    unmap_buffer(buffer, capacity);
+  }
+}
+
+template <size_t S, BufferType B, Tracking M>
+std::byte* DoubleEndedLinearAllocator<S, B, M>::allocate_front(
+    size_t size, size_t alignment) noexcept {
+  if (!is_valid_alignment(alignment)) {
+    return nullptr;
+  }
+  // aligns the address rather than the offset, data may be less aligned
+  uintptr_t base{reinterpret_cast<uintptr_t>(data)};
+  size_t aligned{align_forward(base + front_offset, alignment) - base};
+  if (aligned < front_offset) {  // check uint overflow
+    return nullptr;
+  }
+
+  // the back is the limit rather than the capacity
+  if (aligned > back_offset || size > back_offset - aligned) {
+    return nullptr;
+  }
+
+  previous_front_offset = aligned;
+  front_offset = aligned + size;
+
+  if constexpr (M == Tracking::DEBUG) {
+    allocations[aligned] = size;
+  }
+  return (data + aligned);
+}
+
+template <size_t S, BufferType B, Tracking M>
+std::byte* DoubleEndedLinearAllocator<S, B, M>::allocate_back(
+    size_t size, size_t alignment) noexcept {
+  if (!is_valid_alignment(alignment)) {
+    return nullptr;
+  }
+
+  if (size > back_offset - front_offset) {
+    return nullptr;
+  }
+
+  // bumps down, then aligns the address down
+  uintptr_t base{reinterpret_cast<uintptr_t>(data)};
+  uintptr_t address{(base + back_offset - size) & ~(alignment - 1)};
+  if (address < base + front_offset) {
+    return nullptr;
+  }
+
+  back_offset = address - base;
+
+  if constexpr (M == Tracking::DEBUG) {
+    allocations[back_offset] = size;
+  }
+  return (data + back_offset);
+}
+
+template <size_t S, BufferType B, Tracking M>
+std::byte* DoubleEndedLinearAllocator<S, B, M>::resize_last_front(
+    std::byte* previous_memory, size_t new_size, size_t alignment) noexcept {
+  if (!is_valid_alignment(alignment)) {
+    return nullptr;
+  }
+
+  // verify pointer to previous allocation
+  uintptr_t base{reinterpret_cast<uintptr_t>(data)};
+  size_t previous_aligned{
+      align_forward(base + previous_front_offset, alignment) - base};
+  if (data + previous_aligned != previous_memory) {
+    return nullptr;
+  }
+
+  // check fit against the back
+  if (previous_aligned > back_offset ||
+      new_size > back_offset - previous_aligned) {
+    return nullptr;
+  }
+
+  if constexpr (M == Tracking::DEBUG) {
+    allocations[previous_front_offset] = new_size;
+  }
+
+  // update and return same pointer
+  front_offset = previous_aligned + new_size;
+  return previous_memory;
+}
+
+template <size_t S, BufferType B, Tracking M>
+void DoubleEndedLinearAllocator<S, B, M>::reset_front() noexcept {
+  previous_front_offset = 0;
+  front_offset = 0;
+
+  if constexpr (M == Tracking::DEBUG) {
+    std::erase_if(allocations, [&](const auto& allocation) {
+      return allocation.first < back_offset;
+    });
+  }
+}
+
+template <size_t S, BufferType B, Tracking M>
+void DoubleEndedLinearAllocator<S, B, M>::reset_back() noexcept {
+  if constexpr (M == Tracking::DEBUG) {
+    std::erase_if(allocations, [&](const auto& allocation) {
+      return allocation.first >= back_offset;
+    });
+  }
+
+  back_offset = capacity;
+}
+
+template <size_t S, BufferType B, Tracking M>
+void DoubleEndedLinearAllocator<S, B, M>::reset() noexcept {
+  previous_front_offset = 0;
+  front_offset = 0;
+  back_offset = capacity;
+
+  if constexpr (M == Tracking::DEBUG) {
+    allocations.clear();
+  }
+}
+
+template <size_t S, BufferType B, Tracking M>
+std::string DoubleEndedLinearAllocator<S, B, M>::get_state() const noexcept {
+  try {
+    std::string blocks{};
+    auto append{[&](std::string ptr, size_t offset, size_t size,
+                    std::string_view status) {
+      if (!blocks.empty()) {
+        blocks += ",";
+      }
+      blocks += "{\"ptr\":" + ptr + ",\"offset\":" + std::to_string(offset) +
+                ",\"size\":" + std::to_string(size) +
+                ",\"header\":0,\"status\":\"" + std::string{status} + "\"}";
+    }};
+
+    std::vector<std::pair<uintptr_t, size_t>> pointers{};
+    if constexpr (M == Tracking::DEBUG) {
+      pointers.assign(allocations.begin(), allocations.end());
+      std::ranges::sort(pointers);
+    } else {
+      // individual allocations are not recoverable without headers,
+      // so each end is reported as a single used block
+      if (front_offset > 0) {
+        pointers.emplace_back(0, front_offset);
+      }
+      if (back_offset < capacity) {
+        pointers.emplace_back(back_offset, capacity - back_offset);
+      }
+    }
+
+    // the free gap sits between the two ends
+    auto back{std::ranges::lower_bound(
+        pointers, std::pair<uintptr_t, size_t>{back_offset, 0})};
+    for (auto it{pointers.begin()}; it != back; ++it) {
+      append(std::to_string(it->first), it->first, it->second, "used");
+    }
+    if (front_offset < back_offset) {
+      append("null", front_offset, back_offset - front_offset, "free");
+    }
+    for (auto it{back}; it != pointers.end(); ++it) {
+      append(std::to_string(it->first), it->first, it->second, "used");
+    }
+
+    return "{\"totalBytes\":" + std::to_string(capacity) +
+           ",\"blocks\":[" + blocks +
+           "],\"metrics\":{\"used\":" + std::to_string(get_used()) +
+           ",\"free\":" + std::to_string(get_free()) +
+           ",\"fragmentation\":0}}";
+
+  } catch (...) {
+    return {};
+  }
+}
+
+template <size_t S, BufferType B, Tracking M>
+size_t DoubleEndedLinearAllocator<S, B, M>::get_used() const noexcept {
+  return front_offset + (capacity - back_offset);
+}
+
+template <size_t S, BufferType B, Tracking M>
+size_t DoubleEndedLinearAllocator<S, B, M>::get_free() const noexcept {
+  return back_offset - front_offset;
+}
+
+//////////////////////
+// type-safe helpers
+//////////////////////
+
+template <size_t S, BufferType B, Tracking M>
+template <typename T>
+T* DoubleEndedLinearAllocator<S, B, M>::allocate_front(size_t count) noexcept {
+  if (count > SIZE_MAX / sizeof(T)) {  // check uint overflow
+    return nullptr;
+  }
+
+  size_t size{sizeof(T) * count};
+  size_t alignment{alignof(T)};
+  return reinterpret_cast<T*>(allocate_front(size, alignment));
+}
+
+template <size_t S, BufferType B, Tracking M>
+template <typename T>
+T* DoubleEndedLinearAllocator<S, B, M>::allocate_back(size_t count) noexcept {
+  if (count > SIZE_MAX / sizeof(T)) {  // check uint overflow
+    return nullptr;
+  }
+
+  size_t size{sizeof(T) * count};
+  size_t alignment{alignof(T)};
+  return reinterpret_cast<T*>(allocate_back(size, alignment));
+}
+
+template <size_t S, BufferType B, Tracking M>
+template <typename T, typename... Args>
+T* DoubleEndedLinearAllocator<S, B, M>::emplace_front(Args&&... args) {
+  std::byte* ptr{allocate_front(sizeof(T), alignof(T))};
+  if (!ptr) {
+    return nullptr;
+  }
+
+  return std::construct_at(reinterpret_cast<T*>(ptr),
+                           std::forward<Args>(args)...);
+}
+
+template <size_t S, BufferType B, Tracking M>
+template <typename T, typename... Args>
+T* DoubleEndedLinearAllocator<S, B, M>::emplace_back(Args&&... args) {
+  std::byte* ptr{allocate_back(sizeof(T), alignof(T))};
+  if (!ptr) {
+    return nullptr;
+  }
+
+  return std::construct_at(reinterpret_cast<T*>(ptr),
+                           std::forward<Args>(args)...);
+}
+
+template <size_t S, BufferType B, Tracking M>
+template <typename T>
+void DoubleEndedLinearAllocator<S, B, M>::destroy(T* ptr) noexcept {
+  // asymmetric, does not deallocate (only the resets do)
+  if (ptr) {
+    std::destroy_at(ptr);
+  }
+}
+}  // namespace allocator
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+#include "common.h"
+
+namespace allocator {
+
+// ring of N arenas, each a LinearAllocator or GrowableLinearAllocator.
+// allocations go to the current frame's arena, and next_frame() moves on
+// to the oldest one and resets it, so memory allocated in a frame stays
+// valid for the N - 1 frames after it
+template <typename Arena, size_t N = 2>
+class FrameAllocator {
+ public:
+  static constexpr size_t frame_count = N;
+  // growable arenas have no buffer_type, and are never external
+  static constexpr bool external_arena =
+      requires { requires Arena::buffer_type == BufferType::EXTERNAL; };
+
+  // each arena is constructed from the same args, so every frame has the
+  // same capacity. they are passed on as lvalues, as N arenas share them,
+  // so an Upstream& reaches every arena
+  template <typename... Args>
+  explicit FrameAllocator(Args&&... args)
+    requires(N > 0 && !external_arena &&
+             std::is_constructible_v<Arena, Args&...>);
+  // arenas over BufferType::EXTERNAL each take an equal slice of buf, so
+  // no two frames share memory
+  explicit FrameAllocator(std::span<std::byte> buf)
+    requires(N > 0 && external_arena &&
+             std::is_constructible_v<Arena, std::span<std::byte>>);
+  ~FrameAllocator() noexcept = default;
+
+  FrameAllocator(const FrameAllocator&) = delete;
+  FrameAllocator& operator=(const FrameAllocator&) = delete;
+
+  FrameAllocator(FrameAllocator&&) = delete;
+  FrameAllocator& operator=(FrameAllocator&&) = delete;
+
+  [[nodiscard]] std::byte* allocate(size_t size, size_t alignment) noexcept;
+
+  // resets only the oldest arena, which becomes the current one
+  void next_frame() noexcept;
+  void reset() noexcept;
+
+  // frames since construction or the last reset()
+  size_t get_frame() const noexcept;
+
+  // arena of the current frame, or of the frame age frames before it
+  Arena& get_arena(size_t age = 0) noexcept;
+
+  //////////////////////
+  // type-safe helpers
+  //////////////////////
+  template <typename T>
+  [[nodiscard]] T* allocate(size_t count = 1) noexcept;
+
+  template <typename T, typename... Args>
+  [[nodiscard]] T* emplace(Args&&... args);
+
+  template <typename T>
+  void destroy(T* ptr) noexcept;
+
+ private:
+  // arenas are neither copyable nor movable, so the array is built in place
+  template <typename... Args, size_t... I>
+  static std::array<Arena, N> make_arenas(std::index_sequence<I...>,
+                                          Args&... args);
+  template <size_t... I>
+  static std::array<Arena, N> make_arenas(std::index_sequence<I...>,
+                                          std::span<std::byte> buf);
+
+  std::array<Arena, N> arenas;
+  size_t index;
+  size_t frame;
+};
+}  // namespace allocator
+
+#include "frame_allocator.inl"
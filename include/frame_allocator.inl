@@ -0,0 +1,98 @@
+#pragma once
+
+#include <memory>
+#include <utility>
+
+#include "frame_allocator.h"
+
+namespace allocator {
+template <typename Arena, size_t N>
+template <typename... Args>
+FrameAllocator<Arena, N>::FrameAllocator(Args&&... args)
+  requires(N > 0 && !external_arena &&
+           std::is_constructible_v<Arena, Args&...>)
+    : arenas(make_arenas(std::make_index_sequence<N>{}, args...)),
+      index(0),
+      frame(0) {}
+
+template <typename Arena, size_t N>
+FrameAllocator<Arena, N>::FrameAllocator(std::span<std::byte> buf)
+  requires(N > 0 && external_arena &&
+           std::is_constructible_v<Arena, std::span<std::byte>>)
+    : arenas(make_arenas(std::make_index_sequence<N>{}, buf)),
+      index(0),
+      frame(0) {}
+
+template <typename Arena, size_t N>
+template <typename... Args, size_t... I>
+std::array<Arena, N> FrameAllocator<Arena, N>::make_arenas(
+    std::index_sequence<I...>, Args&... args) {
+  return {((void)I, Arena(args...))...};
+}
+
+template <typename Arena, size_t N>
+template <size_t... I>
+std::array<Arena, N> FrameAllocator<Arena, N>::make_arenas(
+    std::index_sequence<I...>, std::span<std::byte> buf) {
+  // slices are rounded down so that each starts as aligned as buf does
+  size_t slice{buf.size() / N & ~(alignof(std::max_align_t) - 1)};
+  return {Arena(buf.subspan(I * slice, slice))...};
+}
+
+template <typename Arena, size_t N>
+std::byte* FrameAllocator<Arena, N>::allocate(size_t size,
+                                              size_t alignment) noexcept {
+  return arenas[index].allocate(size, alignment);
+}
+
+template <typename Arena, size_t N>
+void FrameAllocator<Arena, N>::next_frame() noexcept {
+  index = index + 1 == N ? 0 : index + 1;
+  ++frame;
+  arenas[index].reset();
+}
+
+template <typename Arena, size_t N>
+void FrameAllocator<Arena, N>::reset() noexcept {
+  for (Arena& arena : arenas) {
+    arena.reset();
+  }
+  index = 0;
+  frame = 0;
+}
+
+template <typename Arena, size_t N>
+size_t FrameAllocator<Arena, N>::get_frame() const noexcept {
+  return frame;
+}
+
+template <typename Arena, size_t N>
+Arena& FrameAllocator<Arena, N>::get_arena(size_t age) noexcept {
+  return arenas[(index + N - age % N) % N];
+}
+
+//////////////////////
+// type-safe helpers
+//////////////////////
+
+template <typename Arena, size_t N>
+template <typename T>
+T* FrameAllocator<Arena, N>::allocate(size_t count) noexcept {
+  return arenas[index].template allocate<T>(count);
+}
+
+template <typename Arena, size_t N>
+template <typename T, typename... Args>
+T* FrameAllocator<Arena, N>::emplace(Args&&... args) {
+  return arenas[index].template emplace<T>(std::forward<Args>(args)...);
+}
+
+template <typename Arena, size_t N>
+template <typename T>
+void FrameAllocator<Arena, N>::destroy(T* ptr) noexcept {
+  // asymmetric, does not deallocate (only next_frame and reset do)
+  if (ptr) {
+    std::destroy_at(ptr);
+  }
+}
+}  // namespace allocator
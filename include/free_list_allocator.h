@@ -9,32 +9,60 @@
 #include <unordered_map>
 
 #include "common.h"
+#include "mmap_buffer.h"
+#include "remote_free_list.h"
 
 namespace allocator {
 
+// every block starts with a tag, the size of the block past the tag with
+// flags in the low bits. free blocks also carry links, and repeat the tag
+// in a footer as their last word, so neighbours are found in O(1)
 struct Node {
+  size_t tag;
+  // list neighbours, or under FitStrategy::BEST the children of the size
+  // tree, holding the larger (next) and smaller (previous) blocks
   Node* next;
-  size_t size;
+  Node* previous;
 };
 
 struct Placement {
-  Node* previous;
   Node* current;
   size_t required;
   size_t padding;
 };
 
+// with Concurrency::OWNER, any thread may deallocate, while allocate(),
+// reset() and get_state() are left to the owning thread
 template <size_t S, BufferType B = BufferType::HEAP,
-          FitStrategy F = FitStrategy::FIRST>
+          FitStrategy F = FitStrategy::FIRST, Tracking M = Tracking::NONE,
+          Concurrency C = Concurrency::NONE>
 class FreeListAllocator {
+  static_assert(C != Concurrency::PER_LEVEL,
+                "a free list has no levels, use Concurrency::OWNER");
+
  public:
+  static constexpr size_t extent = S;
   static constexpr BufferType buffer_type = B;
+  static constexpr FitStrategy fit_strategy = F;
+  static constexpr Tracking tracking = M;
+  static constexpr Concurrency concurrency = C;
+
   explicit FreeListAllocator()
-    requires(S > 0 && B == BufferType::HEAP);
+    requires(S > 0 && S != dynamic_extent && B == BufferType::HEAP);
   explicit FreeListAllocator()
-    requires(S > 0 && B == BufferType::STACK);
+    requires(S > 0 && S != dynamic_extent && B == BufferType::STACK);
   explicit FreeListAllocator(std::array<std::byte, S>& buf)
-    requires(S > 0 && B == BufferType::EXTERNAL);
+    requires(S > 0 && S != dynamic_extent && B == BufferType::EXTERNAL);
+  explicit FreeListAllocator(MapOptions options = {})
+    requires(S > 0 && S != dynamic_extent && B == BufferType::MMAP);
+
+  // capacity chosen at construction, with S = dynamic_extent
+  explicit FreeListAllocator(size_t size)
+    requires(S == dynamic_extent && B == BufferType::HEAP);
+  explicit FreeListAllocator(std::span<std::byte> buf)
+    requires(S == dynamic_extent && B == BufferType::EXTERNAL);
+  explicit FreeListAllocator(size_t size, MapOptions options = {})
+    requires(S == dynamic_extent && B == BufferType::MMAP);
   ~FreeListAllocator() noexcept;
 
   FreeListAllocator(const FreeListAllocator&) = delete;
@@ -45,8 +73,33 @@ class FreeListAllocator {
 
   [[nodiscard]] std::byte* allocate(size_t size, size_t alignment) noexcept;
   void deallocate(std::byte* ptr) noexcept;
+  // size and alignment as passed to allocate(). blocks aligned no further
+  // than a header always have a one word padding, which is then not read.
+  // that load is all it saves, as a block may be larger than size and its
+  // tag is still read for the extent. size is only checked in debug builds
+  void deallocate(std::byte* ptr, [[maybe_unused]] size_t size,
+                  size_t alignment) noexcept;
   void reset() noexcept;
 
+  // resizes the block at ptr in place where it can, growing into the free
+  // block after it or freeing its tail, and moves it otherwise. returns
+  // nullptr, leaving ptr as it was, if it cannot be resized
+  [[nodiscard]] std::byte* reallocate(std::byte* ptr, size_t new_size,
+                                      size_t alignment) noexcept;
+
+  // up to count blocks of size bytes, carved back to back from each free
+  // block found in one pass. writes them to out and returns how many fit,
+  // which is less than count only when out or the free blocks run out
+  [[nodiscard]] size_t allocate_bulk(size_t count, size_t size,
+                                     size_t alignment,
+                                     std::span<std::byte*> out) noexcept;
+  // frees every block in ptrs, skipping nullptr
+  void deallocate_bulk(std::span<std::byte*> ptrs) noexcept;
+
+  // hands the allocator to the calling thread, while no other uses it
+  void set_owner() noexcept
+    requires(C == Concurrency::OWNER);
+
   std::string get_state() const noexcept;
 
   size_t get_used() const noexcept;
@@ -68,15 +121,51 @@ class FreeListAllocator {
   void destroy(T* ptr) noexcept;
 
  private:
+  // deallocate() once the block is known to be this thread's to free
+  void release(std::byte* ptr) noexcept;
+  // with the padding before ptr already known
+  void release(std::byte* ptr, size_t padding) noexcept;
+
+  // padding and size a block needs to start at node
+  static Placement place(Node* node, size_t size, size_t alignment) noexcept;
+
   Placement find_first_fit(size_t size, size_t alignment) noexcept
     requires(F == FitStrategy::FIRST);
 
-  Placement find_best_fit(size_t size, size_t alignmnet) noexcept
+  Placement find_best_fit(size_t size, size_t alignment) noexcept
     requires(F == FitStrategy::BEST);
 
-  Node* handle_next_free(Node* current, size_t required_space,
-                         size_t remaining) noexcept;
-  void handle_links(Node* previous, Node* next) noexcept;
+  static constexpr size_t header_size{sizeof(size_t)};
+  // links and footer must fit once a block is freed
+  static constexpr size_t min_block{sizeof(Node) - header_size +
+                                    sizeof(size_t)};
+
+  static constexpr size_t allocated_flag{1};
+  static constexpr size_t previous_allocated_flag{2};
+
+  static size_t size_of(const Node* node) noexcept;
+  static void write_tags(Node* node, size_t size, size_t flags) noexcept;
+
+  Node* next_block(Node* node) const noexcept;
+  Node* previous_block(Node* node) const noexcept;
+
+  void push_free(Node* node) noexcept;
+  void unlink_free(Node* node) noexcept;
+
+  // allocates placement, an unlinked free block, and as many more blocks
+  // after it as fit, up to out.size(). what is left is freed as one block
+  size_t carve(Placement placement, size_t size, size_t alignment,
+               std::span<std::byte*> out) noexcept;
+  // writes the padding words of an allocated block, returns its user data
+  std::byte* commit(Node* node, size_t padding) noexcept;
+  // shrinks or grows an allocated block to required bytes without moving
+  // it, or returns false when the block after it has no room to grow into
+  bool resize(Node* node, size_t required) noexcept;
+
+  // size tree, a treap ordered by (size, address)
+  static bool tree_less(const Node* lhs, const Node* rhs) noexcept;
+  static size_t tree_priority(const Node* node) noexcept;
+  Node* tree_lower_bound(size_t size) const noexcept;
 
   std::conditional_t<B == BufferType::STACK, std::array<std::byte, S>,
                      std::byte*>
@@ -84,12 +173,17 @@ class FreeListAllocator {
   std::byte* data;
   size_t capacity;
   size_t used;
+  // head of the free list, or root of the size tree under FitStrategy::BEST
   Node* head;
 
-  // for get_state()
-  std::unordered_map<uintptr_t,
-                     std::pair<size_t /* offset */, size_t /* size */>>
+  // for get_state(), compiled out unless Tracking::DEBUG
+  [[no_unique_address]] tracking_map_t<
+      M, std::unordered_map<uintptr_t,
+                            std::pair<size_t /* offset */, size_t /* size */>>>
       allocations;
+
+  // blocks freed by other threads, compiled out unless Concurrency::OWNER
+  [[no_unique_address]] remote_free_list_t<C> remote;
 };
 }  // namespace allocator
 
@@ -3,62 +3,124 @@
 #include <algorithm>
 #include <cassert>
 #include <cstdint>
+#include <cstring>
+#include <memory>
 #include <ranges>
 #include <vector>
 
 #include "free_list_allocator.h"
 
 namespace allocator {
-template <size_t S, BufferType B, FitStrategy F>
-FreeListAllocator<S, B, F>::FreeListAllocator()
-  requires(S > 0 && B == BufferType::HEAP)
+template <size_t S, BufferType B, FitStrategy F, Tracking M, Concurrency C>
+FreeListAllocator<S, B, F, M, C>::FreeListAllocator()
+  requires(S > 0 && S != dynamic_extent && B == BufferType::HEAP)
     : buffer(static_cast<std::byte*>(::operator new(S))),
       data(buffer),
-      capacity(S),
+      capacity(S - S % alignof(Node)),
       used(0),
-      head(reinterpret_cast<Node*>(buffer)) {
-  head->size = S - sizeof(Node);
-  head->next = nullptr;
+      head(nullptr) {
+  reset();
 }
 
-template <size_t S, BufferType B, FitStrategy F>
-FreeListAllocator<S, B, F>::FreeListAllocator()
-  requires(S > 0 && B == BufferType::STACK)
+template <size_t S, BufferType B, FitStrategy F, Tracking M, Concurrency C>
+FreeListAllocator<S, B, F, M, C>::FreeListAllocator()
+  requires(S > 0 && S != dynamic_extent && B == BufferType::STACK)
     : buffer(std::array<std::byte, S>{}),
       data(buffer.data()),
-      capacity(S),
+      capacity(S - S % alignof(Node)),
       used(0),
-      head(reinterpret_cast<Node*>(buffer.data())) {
-  head->next = nullptr;
-  head->size = S - sizeof(Node);
+      head(nullptr) {
+  reset();
 }
 
-template <size_t S, BufferType B, FitStrategy F>
-FreeListAllocator<S, B, F>::FreeListAllocator(std::array<std::byte, S>& buf)
-  requires(S > 0 && B == BufferType::EXTERNAL)
-    : buffer(buf.data()),
-      data(buf.data()),
-      capacity(buf.size()),
+template <size_t S, BufferType B, FitStrategy F, Tracking M, Concurrency C>
+FreeListAllocator<S, B, F, M, C>::FreeListAllocator(
+    std::array<std::byte, S>& buf)
+  requires(S > 0 && S != dynamic_extent && B == BufferType::EXTERNAL)
+    : buffer(buf.data()), used(0), head(nullptr) {
+  // ensures buffer pointer is aligned
+  data = reinterpret_cast<std::byte*>(align_forward(
+      reinterpret_cast<size_t>(buf.data()), alignof(std::max_align_t)));
+  capacity = S - (data - buf.data());
+  capacity -= capacity % alignof(Node);
+
+  reset();
+}
+
+template <size_t S, BufferType B, FitStrategy F, Tracking M, Concurrency C>
+FreeListAllocator<S, B, F, M, C>::FreeListAllocator(MapOptions options)
+  requires(S > 0 && S != dynamic_extent && B == BufferType::MMAP)
+    : buffer(map_buffer(S - S % alignof(Node), options)),
+      data(buffer),
+      capacity(S - S % alignof(Node)),
       used(0),
-      head(reinterpret_cast<Node*>(buf.data())) {
-  head->next = nullptr;
-  head->size = capacity - sizeof(Node);
+      head(nullptr) {
+  reset();
 }
 
-template <size_t S, BufferType B, FitStrategy F>
-FreeListAllocator<S, B, F>::~FreeListAllocator() noexcept {
+template <size_t S, BufferType B, FitStrategy F, Tracking M, Concurrency C>
+FreeListAllocator<S, B, F, M, C>::FreeListAllocator(size_t size)
+  requires(S == dynamic_extent && B == BufferType::HEAP)
+    : buffer(static_cast<std::byte*>(::operator new(size))),
+      data(buffer),
+      capacity(size - size % alignof(Node)),
+      used(0),
+      head(nullptr) {
+  assert(capacity >= header_size + min_block && "capacity is too small");
+  reset();
+}
+
+template <size_t S, BufferType B, FitStrategy F, Tracking M, Concurrency C>
+FreeListAllocator<S, B, F, M, C>::FreeListAllocator(std::span<std::byte> buf)
+  requires(S == dynamic_extent && B == BufferType::EXTERNAL)
+    : buffer(buf.data()), used(0), head(nullptr) {
+  // ensures buffer pointer is aligned
+  data = reinterpret_cast<std::byte*>(align_forward(
+      reinterpret_cast<size_t>(buf.data()), alignof(std::max_align_t)));
+  capacity = buf.size() - std::min<size_t>(data - buf.data(), buf.size());
+  capacity -= capacity % alignof(Node);
+
+  assert(capacity >= header_size + min_block && "capacity is too small");
+  reset();
+}
+
+template <size_t S, BufferType B, FitStrategy F, Tracking M, Concurrency C>
+FreeListAllocator<S, B, F, M, C>::FreeListAllocator(size_t size,
+                                                    MapOptions options)
+  requires(S == dynamic_extent && B == BufferType::MMAP)
+    : buffer(map_buffer(size - size % alignof(Node), options)),
+      data(buffer),
+      capacity(size - size % alignof(Node)),
+      used(0),
+      head(nullptr) {
+  assert(capacity >= header_size + min_block && "capacity is too small");
+  reset();
+}
+
+template <size_t S, BufferType B, FitStrategy F, Tracking M, Concurrency C>
+FreeListAllocator<S, B, F, M, C>::~FreeListAllocator() noexcept {
   if constexpr (B == BufferType::HEAP) {
     ::operator delete(buffer);
+  } else if constexpr (B == BufferType::MMAP) {
+    // only the capacity was mapped
+    unmap_buffer(buffer, capacity);
   }
 }
 
-template <size_t S, BufferType B, FitStrategy F>
-std::byte* FreeListAllocator<S, B, F>::allocate(size_t size,
+template <size_t S, BufferType B, FitStrategy F, Tracking M, Concurrency C>
+std::byte* FreeListAllocator<S, B, F, M, C>::allocate(size_t size,
                                                 size_t alignment) noexcept {
   if (!is_valid_alignment(alignment)) {
     return nullptr;
   }
 
+  if constexpr (C == Concurrency::OWNER) {
+    // blocks other threads freed since the last call are reused first
+    remote.drain([this](std::byte* ptr) { release(ptr); });
+    // and a remote free links the block through its first word
+    size = std::max(size, sizeof(std::byte*));
+  }
+
   Placement placement{};
   if constexpr (F == FitStrategy::FIRST) {
     placement = find_first_fit(size, alignment);
@@ -70,158 +132,334 @@ std::byte* FreeListAllocator<S, B, F>::allocate(size_t size,
     return nullptr;
   }
 
-  size_t remaining{placement.current->size - placement.required};
+  unlink_free(placement.current);
 
-  Node* next{
-      handle_next_free(placement.current, placement.required, remaining)};
-  handle_links(placement.previous, next);
+  std::byte* ptr{};
+  carve(placement, size, alignment, std::span{&ptr, 1});
+  return ptr;
+}
 
-  placement.current->size = placement.required;
-  used += placement.required;
+template <size_t S, BufferType B, FitStrategy F, Tracking M, Concurrency C>
+size_t FreeListAllocator<S, B, F, M, C>::allocate_bulk(
+    size_t count, size_t size, size_t alignment,
+    std::span<std::byte*> out) noexcept {
+  if (!is_valid_alignment(alignment)) {
+    return 0;
+  }
 
-  uintptr_t aligned{reinterpret_cast<uintptr_t>(placement.current) +
-                    sizeof(Node) + placement.padding};
-  // adds padding pointer right before user data
-  *reinterpret_cast<size_t*>(aligned - sizeof(size_t)) = placement.padding;
+  if constexpr (C == Concurrency::OWNER) {
+    remote.drain([this](std::byte* ptr) { release(ptr); });
+    size = std::max(size, sizeof(std::byte*));
+  }
 
-  uintptr_t ptr{
-      static_cast<uintptr_t>(aligned - reinterpret_cast<uintptr_t>(data))};
-  size_t offset{static_cast<size_t>(
-      reinterpret_cast<std::byte*>(placement.current) - data)};
-  allocations[ptr] = {offset, placement.required};
-  return reinterpret_cast<std::byte*>(aligned);
+  out = out.first(std::min(count, out.size()));
+  size_t allocated{};
+
+  if constexpr (F == FitStrategy::FIRST) {
+    Node* current{head};
+    while (current != nullptr && allocated < out.size()) {
+      // carving pushes what is left to the front, so the walk carries on
+      // from the block that came after this one
+      Node* next{current->next};
+
+      Placement placement{place(current, size, alignment)};
+      if (size_of(current) >= placement.required) {
+        unlink_free(current);
+        allocated += carve(placement, size, alignment, out.subspan(allocated));
+      }
+
+      current = next;
+    }
+  } else if constexpr (F == FitStrategy::BEST) {
+    while (allocated < out.size()) {
+      Placement placement{find_best_fit(size, alignment)};
+      if (placement.current == nullptr) {
+        break;
+      }
+
+      unlink_free(placement.current);
+      allocated += carve(placement, size, alignment, out.subspan(allocated));
+    }
+  }
+
+  return allocated;
+}
+
+template <size_t S, BufferType B, FitStrategy F, Tracking M, Concurrency C>
+void FreeListAllocator<S, B, F, M, C>::deallocate(std::byte* ptr) noexcept {
+  if (!ptr) {
+    return;
+  }
+
+  if constexpr (C == Concurrency::OWNER) {
+    if (!remote.is_owner()) {
+      remote.push(ptr);
+      return;
+    }
+  }
+
+  release(ptr);
 }
 
-template <size_t S, BufferType B, FitStrategy F>
-void FreeListAllocator<S, B, F>::deallocate(std::byte* ptr) noexcept {
+template <size_t S, BufferType B, FitStrategy F, Tracking M, Concurrency C>
+void FreeListAllocator<S, B, F, M, C>::deallocate(
+    std::byte* ptr, [[maybe_unused]] size_t size, size_t alignment) noexcept {
   if (!ptr) {
     return;
   }
 
+  if constexpr (C == Concurrency::OWNER) {
+    if (!remote.is_owner()) {
+      remote.push(ptr);
+      return;
+    }
+  }
+
+  // headers sit on alignof(Node), so the word after one is already aligned
+  // for these and user data follows it directly
+  if (alignment > alignof(Node)) {
+    release(ptr);
+    return;
+  }
+
   assert(ptr >= data && ptr <= data + capacity && "pointer is out of bounds");
+  assert(*(reinterpret_cast<size_t*>(ptr - sizeof(size_t))) ==
+             sizeof(size_t) &&
+         "alignment does not match the allocation");
+  assert(size <= size_of(reinterpret_cast<Node*>(ptr - header_size -
+                                                 sizeof(size_t))) -
+                     sizeof(size_t) &&
+         "size does not match the allocation");
+  release(ptr, sizeof(size_t));
+}
 
-  size_t padding{*(reinterpret_cast<size_t*>(ptr - sizeof(size_t)))};
-  Node* node{reinterpret_cast<Node*>(ptr - sizeof(Node) - padding)};
+template <size_t S, BufferType B, FitStrategy F, Tracking M, Concurrency C>
+std::byte* FreeListAllocator<S, B, F, M, C>::reallocate(
+    std::byte* ptr, size_t new_size, size_t alignment) noexcept {
+  if (!ptr) {
+    return allocate(new_size, alignment);
+  }
 
-  size_t block_size{node->size};
+  if (!is_valid_alignment(alignment) || new_size > capacity) {
+    return nullptr;
+  }
 
-  Node* current{head};
-  Node* previous{};
+  assert(ptr >= data && ptr <= data + capacity && "pointer is out of bounds");
 
-  while (current != nullptr) {
-    if (current > node) {
-      break;
+  size_t padding{*(reinterpret_cast<size_t*>(ptr - sizeof(size_t)))};
+  Node* node{reinterpret_cast<Node*>(ptr - header_size - padding)};
+  size_t block_size{size_of(node)};
+
+  // the block stays where it is, so only a pointer that is already aligned
+  // can be resized in place
+  size_t required{
+      std::max(align_forward(new_size + padding, alignof(Node)), min_block)};
+  if ((reinterpret_cast<uintptr_t>(ptr) & (alignment - 1)) == 0 &&
+      resize(node, required)) {
+    if constexpr (M == Tracking::DEBUG) {
+      allocations[static_cast<uintptr_t>(ptr - data)].second = size_of(node);
     }
-    previous = current;
-    current = current->next;
+    return ptr;
   }
 
-  std::byte* block_start{reinterpret_cast<std::byte*>(node)};
-  std::byte* block_end{block_start + block_size + sizeof(Node)};
-  std::byte* current_start{};
-  std::byte* previous_end{};
+  // no room after the block, so the contents move to a new one
+  std::byte* moved{allocate(new_size, alignment)};
+  if (!moved) {
+    return nullptr;
+  }
+
+  std::memcpy(moved, ptr, std::min(block_size - padding, new_size));
+  release(ptr);
+  return moved;
+}
 
-  if (previous) {
-    previous_end =
-        reinterpret_cast<std::byte*>(previous) + previous->size + sizeof(Node);
+template <size_t S, BufferType B, FitStrategy F, Tracking M, Concurrency C>
+void FreeListAllocator<S, B, F, M, C>::deallocate_bulk(
+    std::span<std::byte*> ptrs) noexcept {
+  if constexpr (C == Concurrency::OWNER) {
+    // one ownership check for the whole batch
+    if (!remote.is_owner()) {
+      for (std::byte* ptr : ptrs) {
+        if (ptr) {
+          remote.push(ptr);
+        }
+      }
+      return;
+    }
   }
-  if (current) {
-    current_start = reinterpret_cast<std::byte*>(current);
+
+  for (std::byte* ptr : ptrs) {
+    if (ptr) {
+      release(ptr);
+    }
   }
+}
 
-  if (previous_end == block_start && current_start == block_end) {
-    previous->size += block_size + sizeof(Node) + current->size + sizeof(Node);
-    previous->next = current->next;
+template <size_t S, BufferType B, FitStrategy F, Tracking M, Concurrency C>
+void FreeListAllocator<S, B, F, M, C>::release(std::byte* ptr) noexcept {
+  assert(ptr >= data && ptr <= data + capacity && "pointer is out of bounds");
+  release(ptr, *(reinterpret_cast<size_t*>(ptr - sizeof(size_t))));
+}
 
-  } else if (previous_end == block_start) {
-    previous->size += block_size + sizeof(Node);
+template <size_t S, BufferType B, FitStrategy F, Tracking M, Concurrency C>
+void FreeListAllocator<S, B, F, M, C>::release(std::byte* ptr,
+                                               size_t padding) noexcept {
+  Node* node{reinterpret_cast<Node*>(ptr - header_size - padding)};
 
-  } else if (current_start == block_end) {
-    node->size = block_size + current->size + sizeof(Node);
-    node->next = current->next;
-    handle_links(previous, node);
+  size_t block_size{size_of(node)};
+  used -= block_size;
 
-  } else {
-    node->size = block_size;
-    node->next = current;
-    handle_links(previous, node);
+  // neighbours come from the boundary tags, no list traversal
+  size_t merged{block_size};
+  Node* next{next_block(node)};
+  if (next && !(next->tag & allocated_flag)) {
+    unlink_free(next);
+    merged += header_size + size_of(next);
   }
 
-  allocations.erase(static_cast<uintptr_t>(ptr - data));
-  used -= block_size;
+  if (!(node->tag & previous_allocated_flag)) {
+    Node* previous{previous_block(node)};
+    unlink_free(previous);
+    merged += header_size + size_of(previous);
+    node = previous;
+  }
+
+  // free blocks never neighbour each other, so whatever is left of the
+  // merged block is allocated (or the start of the buffer)
+  write_tags(node, merged, previous_allocated_flag);
+  push_free(node);
+
+  if (Node* after{next_block(node)}) {
+    after->tag &= ~previous_allocated_flag;
+  }
+
+  if constexpr (M == Tracking::DEBUG) {
+    allocations.erase(static_cast<uintptr_t>(ptr - data));
+  }
 }
 
-template <size_t S, BufferType B, FitStrategy F>
-void FreeListAllocator<S, B, F>::reset() noexcept {
+template <size_t S, BufferType B, FitStrategy F, Tracking M, Concurrency C>
+void FreeListAllocator<S, B, F, M, C>::reset() noexcept {
+  if constexpr (C == Concurrency::OWNER) {
+    // reclaimed along with everything else
+    remote.drain([](std::byte*) {});
+  }
+
   used = 0;
+  head = nullptr;
 
-  if constexpr (B == BufferType::STACK) {
-    head = reinterpret_cast<Node*>(buffer.data());
-  } else {
-    head = reinterpret_cast<Node*>(buffer);
-  }
+  // nothing precedes the first block, treated as allocated so it is
+  // never coalesced with
+  Node* node{reinterpret_cast<Node*>(data)};
+  write_tags(node, capacity - header_size, previous_allocated_flag);
+  push_free(node);
 
-  head->size = S - sizeof(Node);
-  head->next = nullptr;
+  if constexpr (M == Tracking::DEBUG) {
+    allocations.clear();
+  }
+}
 
-  allocations.clear();
+template <size_t S, BufferType B, FitStrategy F, Tracking M, Concurrency C>
+void FreeListAllocator<S, B, F, M, C>::set_owner() noexcept
+  requires(C == Concurrency::OWNER)
+{
+  remote.set_owner();
 }
 
-template <size_t S, BufferType B, FitStrategy F>
-std::string FreeListAllocator<S, B, F>::get_state() const noexcept {
+template <size_t S, BufferType B, FitStrategy F, Tracking M, Concurrency C>
+std::string FreeListAllocator<S, B, F, M, C>::get_state() const noexcept {
   try {
-    std::vector<std::pair<uintptr_t, std::pair<size_t, size_t>>> pointers(
-        allocations.begin(), allocations.end());
-    std::ranges::sort(pointers);
-
     std::string blocks{};
-    for (const auto& [ptr, info] : pointers) {
-      const auto& [start, size] = info;
-      if (!blocks.empty()) {
-        blocks += ",";
-      }
 
-      blocks += "{\"ptr\":" + std::to_string(ptr) +
-                ",\"offset\":" + std::to_string(start) +
-                ",\"size\":" + std::to_string(size) +
-                ",\"header\":" + std::to_string(ptr - start) +
-                ",\"status\":\"used\"}";
-    }
-
-    Node* node{head};
-    while (node != nullptr) {
-      size_t start{
-          static_cast<size_t>(reinterpret_cast<std::byte*>(node) - data)};
-
-      if (!blocks.empty()) {
-        blocks += ",";
+    if constexpr (M == Tracking::DEBUG) {
+      std::vector<std::pair<uintptr_t, std::pair<size_t, size_t>>> pointers(
+          allocations.begin(), allocations.end());
+      std::ranges::sort(pointers);
+
+      for (const auto& [ptr, info] : pointers) {
+        const auto& [start, size] = info;
+        if (!blocks.empty()) {
+          blocks += ",";
+        }
+
+        blocks += "{\"ptr\":" + std::to_string(ptr) +
+                  ",\"offset\":" + std::to_string(start) +
+                  ",\"size\":" + std::to_string(size) +
+                  ",\"header\":" + std::to_string(ptr - start) +
+                  ",\"status\":\"used\"}";
       }
-      blocks += "{\"ptr\":null,\"offset\":" + std::to_string(start) +
-                ",\"size\":" + std::to_string(node->size) +
-                ",\"header\":" + std::to_string(sizeof(Node)) +
-                ",\"status\":\"free\"}";
 
-      node = node->next;
+      // free blocks are found from the tags, as under BEST they sit in a
+      // tree rather than a list
+      std::byte* position{data};
+      while (position < data + capacity) {
+        Node* node{reinterpret_cast<Node*>(position)};
+        size_t start{static_cast<size_t>(position - data)};
+
+        if (!(node->tag & allocated_flag)) {
+          if (!blocks.empty()) {
+            blocks += ",";
+          }
+          blocks += "{\"ptr\":null,\"offset\":" + std::to_string(start) +
+                    ",\"size\":" + std::to_string(size_of(node)) +
+                    ",\"header\":" + std::to_string(header_size) +
+                    ",\"status\":\"free\"}";
+        }
+
+        position += header_size + size_of(node);
+      }
+    } else {
+      // blocks tile the buffer and the tags say which are free, so a
+      // single pass classifies every block
+      std::byte* position{data};
+
+      while (position < data + capacity) {
+        Node* node{reinterpret_cast<Node*>(position)};
+        size_t start{static_cast<size_t>(position - data)};
+
+        if (!blocks.empty()) {
+          blocks += ",";
+        }
+
+        if (!(node->tag & allocated_flag)) {
+          blocks += "{\"ptr\":null,\"offset\":" + std::to_string(start) +
+                    ",\"size\":" + std::to_string(size_of(node)) +
+                    ",\"header\":" + std::to_string(header_size) +
+                    ",\"status\":\"free\"}";
+        } else {
+          size_t padding{
+              *reinterpret_cast<const size_t*>(position + header_size)};
+          size_t header{header_size + padding};
+          blocks += "{\"ptr\":" + std::to_string(start + header) +
+                    ",\"offset\":" + std::to_string(start) +
+                    ",\"size\":" + std::to_string(size_of(node)) +
+                    ",\"header\":" + std::to_string(header) +
+                    ",\"status\":\"used\"}";
+        }
+
+        position += header_size + size_of(node);
+      }
     }
 
-    return "{\"totalBytes\":" + std::to_string(S) +
+    return "{\"totalBytes\":" + std::to_string(capacity) +
            ",\"nodeSize\":" + std::to_string(sizeof(Node)) +
            ",\"ptrSize\":" + std::to_string(sizeof(Node*)) + ",\"blocks\":[" +
            blocks + "],\"metrics\":{\"used\":" + std::to_string(used) +
-           ",\"free\":" + std::to_string(S - used) + ",\"fragmentation\":0}}";
+           ",\"free\":" + std::to_string(capacity - used) +
+           ",\"fragmentation\":0}}";
 
   } catch (...) {
     return {};
   }
 }
 
-template <size_t S, BufferType B, FitStrategy F>
-size_t FreeListAllocator<S, B, F>::get_used() const noexcept {
+template <size_t S, BufferType B, FitStrategy F, Tracking M, Concurrency C>
+size_t FreeListAllocator<S, B, F, M, C>::get_used() const noexcept {
   return used;
 }
 
-template <size_t S, BufferType B, FitStrategy F>
-size_t FreeListAllocator<S, B, F>::get_free() const noexcept {
+template <size_t S, BufferType B, FitStrategy F, Tracking M, Concurrency C>
+size_t FreeListAllocator<S, B, F, M, C>::get_free() const noexcept {
   return capacity - used;
 }
 
@@ -229,9 +467,9 @@ size_t FreeListAllocator<S, B, F>::get_free() const noexcept {
 // type-safe helpers
 //////////////////////
 
-template <size_t S, BufferType B, FitStrategy F>
+template <size_t S, BufferType B, FitStrategy F, Tracking M, Concurrency C>
 template <typename T>
-T* FreeListAllocator<S, B, F>::allocate(size_t count) noexcept {
+T* FreeListAllocator<S, B, F, M, C>::allocate(size_t count) noexcept {
   if (count > SIZE_MAX / sizeof(T)) {
     return nullptr;
   }
@@ -241,15 +479,15 @@ T* FreeListAllocator<S, B, F>::allocate(size_t count) noexcept {
   return reinterpret_cast<T*>(allocate(size, alignment));
 }
 
-template <size_t S, BufferType B, FitStrategy F>
+template <size_t S, BufferType B, FitStrategy F, Tracking M, Concurrency C>
 template <typename T>
-void FreeListAllocator<S, B, F>::deallocate(T* ptr) noexcept {
+void FreeListAllocator<S, B, F, M, C>::deallocate(T* ptr) noexcept {
   deallocate(reinterpret_cast<std::byte*>(ptr));
 }
 
-template <size_t S, BufferType B, FitStrategy F>
+template <size_t S, BufferType B, FitStrategy F, Tracking M, Concurrency C>
 template <typename T, typename... Args>
-T* FreeListAllocator<S, B, F>::emplace(Args&&... args) {
+T* FreeListAllocator<S, B, F, M, C>::emplace(Args&&... args) {
   size_t size{sizeof(T)};
   size_t alignment{alignof(T)};
 
@@ -262,9 +500,9 @@ T* FreeListAllocator<S, B, F>::emplace(Args&&... args) {
                            std::forward<Args>(args)...);
 }
 
-template <size_t S, BufferType B, FitStrategy F>
+template <size_t S, BufferType B, FitStrategy F, Tracking M, Concurrency C>
 template <typename T>
-void FreeListAllocator<S, B, F>::destroy(T* ptr) noexcept {
+void FreeListAllocator<S, B, F, M, C>::destroy(T* ptr) noexcept {
   // asymmetric, does not deallocate (only reset does)
   if (ptr) {
     std::destroy_at(ptr);
@@ -275,101 +513,340 @@ void FreeListAllocator<S, B, F>::destroy(T* ptr) noexcept {
 // helpers
 //////////////////////
 
-template <size_t S, BufferType B, FitStrategy F>
-Placement FreeListAllocator<S, B, F>::find_first_fit(size_t size,
+template <size_t S, BufferType B, FitStrategy F, Tracking M, Concurrency C>
+Placement FreeListAllocator<S, B, F, M, C>::place(Node* node, size_t size,
+                                                  size_t alignment) noexcept {
+  uintptr_t block{reinterpret_cast<uintptr_t>(node) + header_size +
+                  sizeof(size_t)};
+  uintptr_t aligned{align_forward(block, alignment)};
+  size_t padding{aligned - (reinterpret_cast<uintptr_t>(node) + header_size)};
+  // rounded so every header, and the padding word, stays aligned
+  size_t required{
+      std::max(align_forward(size + padding, alignof(Node)), min_block)};
+
+  return Placement{node, required, padding};
+}
+
+template <size_t S, BufferType B, FitStrategy F, Tracking M, Concurrency C>
+Placement FreeListAllocator<S, B, F, M, C>::find_first_fit(size_t size,
                                                      size_t alignment) noexcept
   requires(F == FitStrategy::FIRST)
 {
   Node* current{head};
-  Node* previous{};
 
   while (current != nullptr) {
-    uintptr_t block{reinterpret_cast<uintptr_t>(current) + sizeof(Node) +
-                    sizeof(size_t)};
-    uintptr_t aligned{align_forward(block, alignment)};
-    size_t padding{aligned -
-                   (reinterpret_cast<uintptr_t>(current) + sizeof(Node))};
-    size_t required{size + padding};
-
-    if (current->size >= required) {
-      return Placement{previous, current, required, padding};
+    Placement placement{place(current, size, alignment)};
+    if (size_of(current) >= placement.required) {
+      return placement;
     }
 
-    previous = current;
     current = current->next;
   }
 
-  return {nullptr, nullptr, 0, 0};
+  return {nullptr, 0, 0};
 }
 
-template <size_t S, BufferType B, FitStrategy F>
-Placement FreeListAllocator<S, B, F>::find_best_fit(size_t size,
+template <size_t S, BufferType B, FitStrategy F, Tracking M, Concurrency C>
+Placement FreeListAllocator<S, B, F, M, C>::find_best_fit(size_t size,
                                                     size_t alignment) noexcept
   requires(F == FitStrategy::BEST)
 {
-  size_t min_diff{SIZE_MAX};
-  Placement best{nullptr, nullptr, 0, 0};
+  // padding depends on where a block sits, so look up the smallest block
+  // that fits with the least padding, and fall back to the smallest block
+  // that fits with the most
+  for (size_t padding : {sizeof(size_t), std::max(alignment, sizeof(size_t))}) {
+    size_t bound{
+        std::max(align_forward(size + padding, alignof(Node)), min_block)};
+    Node* current{tree_lower_bound(bound)};
+    if (current == nullptr) {
+      return {nullptr, 0, 0};
+    }
 
-  Node* current{head};
-  Node* previous{};
+    Placement placement{place(current, size, alignment)};
+    if (size_of(current) >= placement.required) {
+      return placement;
+    }
+  }
 
-  while (current != nullptr) {
-    uintptr_t block{reinterpret_cast<uintptr_t>(current) + sizeof(Node) +
-                    sizeof(size_t)};
-    uintptr_t aligned{align_forward(block, alignment)};
-    size_t padding{aligned -
-                   (reinterpret_cast<uintptr_t>(current) + sizeof(Node))};
-    size_t required{size + padding};
-
-    if (current->size >= required) {
-      size_t diff{current->size - required};
-
-      if (diff == 0) {
-        return Placement{previous, current, required, padding};
-      }
+  return {nullptr, 0, 0};
+}
+
+template <size_t S, BufferType B, FitStrategy F, Tracking M, Concurrency C>
+size_t FreeListAllocator<S, B, F, M, C>::size_of(const Node* node) noexcept {
+  return node->tag & ~(allocated_flag | previous_allocated_flag);
+}
 
-      if (diff < min_diff) {
-        min_diff = diff;
+template <size_t S, BufferType B, FitStrategy F, Tracking M, Concurrency C>
+void FreeListAllocator<S, B, F, M, C>::write_tags(Node* node, size_t size,
+                                                  size_t flags) noexcept {
+  node->tag = size | flags;
 
-        best.previous = previous;
-        best.current = current;
-        best.required = required;
-        best.padding = padding;
+  // only free blocks carry a footer, allocated blocks hand it to the user
+  if (!(flags & allocated_flag)) {
+    *reinterpret_cast<size_t*>(reinterpret_cast<std::byte*>(node) +
+                               header_size + size - sizeof(size_t)) = size;
+  }
+}
+
+template <size_t S, BufferType B, FitStrategy F, Tracking M, Concurrency C>
+Node* FreeListAllocator<S, B, F, M, C>::next_block(Node* node) const noexcept {
+  std::byte* next{reinterpret_cast<std::byte*>(node) + header_size +
+                  size_of(node)};
+  if (next >= data + capacity) {
+    return nullptr;
+  }
+
+  return reinterpret_cast<Node*>(next);
+}
+
+template <size_t S, BufferType B, FitStrategy F, Tracking M, Concurrency C>
+Node* FreeListAllocator<S, B, F, M, C>::previous_block(
+    Node* node) const noexcept {
+  // only valid when the previous block is free, i.e. has a footer
+  std::byte* position{reinterpret_cast<std::byte*>(node)};
+  size_t size{*reinterpret_cast<const size_t*>(position - sizeof(size_t))};
+
+  return reinterpret_cast<Node*>(position - size - header_size);
+}
+
+template <size_t S, BufferType B, FitStrategy F, Tracking M, Concurrency C>
+void FreeListAllocator<S, B, F, M, C>::push_free(Node* node) noexcept {
+  if constexpr (F == FitStrategy::BEST) {
+    // descend while parents outrank the node, then split the subtree
+    // below by key into the node's children
+    Node** link{&head};
+    while (*link && tree_priority(*link) > tree_priority(node)) {
+      link = tree_less(node, *link) ? &(*link)->previous : &(*link)->next;
+    }
+
+    Node* current{*link};
+    Node** smaller{&node->previous};
+    Node** larger{&node->next};
+    while (current) {
+      if (tree_less(current, node)) {
+        *smaller = current;
+        smaller = &current->next;
+        current = current->next;
+      } else {
+        *larger = current;
+        larger = &current->previous;
+        current = current->previous;
       }
     }
 
-    previous = current;
-    current = current->next;
+    *smaller = nullptr;
+    *larger = nullptr;
+    *link = node;
+  } else {
+    node->previous = nullptr;
+    node->next = head;
+    if (head) {
+      head->previous = node;
+    }
+    head = node;
   }
+}
 
-  return best;
+template <size_t S, BufferType B, FitStrategy F, Tracking M, Concurrency C>
+void FreeListAllocator<S, B, F, M, C>::unlink_free(Node* node) noexcept {
+  if constexpr (F == FitStrategy::BEST) {
+    Node** link{&head};
+    while (*link != node) {
+      link = tree_less(node, *link) ? &(*link)->previous : &(*link)->next;
+    }
+
+    // merge the children in place of the node
+    Node* smaller{node->previous};
+    Node* larger{node->next};
+    while (smaller && larger) {
+      if (tree_priority(smaller) > tree_priority(larger)) {
+        *link = smaller;
+        link = &smaller->next;
+        smaller = smaller->next;
+      } else {
+        *link = larger;
+        link = &larger->previous;
+        larger = larger->previous;
+      }
+    }
+
+    *link = smaller ? smaller : larger;
+  } else {
+    if (node->previous) {
+      node->previous->next = node->next;
+    } else {
+      head = node->next;
+    }
+
+    if (node->next) {
+      node->next->previous = node->previous;
+    }
+  }
 }
 
-template <size_t S, BufferType B, FitStrategy F>
-Node* FreeListAllocator<S, B, F>::handle_next_free(Node* current,
-                                                   size_t required_space,
-                                                   size_t remaining) noexcept {
-  if (remaining <= sizeof(Node)) {
-    return current->next;
+template <size_t S, BufferType B, FitStrategy F, Tracking M, Concurrency C>
+bool FreeListAllocator<S, B, F, M, C>::resize(Node* node,
+                                              size_t required) noexcept {
+  size_t block_size{size_of(node)};
+  size_t flags{allocated_flag | (node->tag & previous_allocated_flag)};
+  Node* next{next_block(node)};
+  bool next_free{next && !(next->tag & allocated_flag)};
+
+  if (required <= block_size) {
+    size_t remaining{block_size - required};
+    if (remaining < header_size + min_block) {
+      return true;
+    }
+
+    // the tail goes back to the free list, merged with a free block after it
+    Node* tail{reinterpret_cast<Node*>(reinterpret_cast<std::byte*>(node) +
+                                       header_size + required)};
+    size_t tail_size{remaining - header_size};
+    if (next_free) {
+      unlink_free(next);
+      tail_size += header_size + size_of(next);
+    } else if (next) {
+      next->tag &= ~previous_allocated_flag;
+    }
+
+    write_tags(node, required, flags);
+    write_tags(tail, tail_size, previous_allocated_flag);
+    push_free(tail);
+    used -= remaining;
+    return true;
+  }
+
+  if (!next_free || block_size + header_size + size_of(next) < required) {
+    return false;
   }
 
-  Node* split{reinterpret_cast<Node*>(reinterpret_cast<std::byte*>(current) +
-                                      sizeof(Node) + required_space)};
+  unlink_free(next);
+  size_t merged{block_size + header_size + size_of(next)};
+  size_t remaining{merged - required};
 
-  split->size = remaining - sizeof(Node);
-  split->next = current->next;
+  if (remaining < header_size + min_block) {
+    // tail is too small to split, absorb it so blocks tile the buffer
+    write_tags(node, merged, flags);
+    if (Node* after{next_block(node)}) {
+      after->tag |= previous_allocated_flag;
+    }
+  } else {
+    Node* split{reinterpret_cast<Node*>(reinterpret_cast<std::byte*>(node) +
+                                        header_size + required)};
+    write_tags(node, required, flags);
+    write_tags(split, remaining - header_size, previous_allocated_flag);
+    push_free(split);
+  }
 
-  return split;
+  used += size_of(node) - block_size;
+  return true;
 }
 
-template <size_t S, BufferType B, FitStrategy F>
-void FreeListAllocator<S, B, F>::handle_links(Node* previous,
-                                              Node* next) noexcept {
-  if (previous == nullptr) {
-    head = next;
+template <size_t S, BufferType B, FitStrategy F, Tracking M, Concurrency C>
+size_t FreeListAllocator<S, B, F, M, C>::carve(
+    Placement placement, size_t size, size_t alignment,
+    std::span<std::byte*> out) noexcept {
+  Node* node{placement.current};
+  std::byte* end{reinterpret_cast<std::byte*>(node) + header_size +
+                 size_of(node)};
+  size_t flags{node->tag & previous_allocated_flag};
+
+  size_t carved{};
+  while (true) {
+    size_t available{static_cast<size_t>(
+        end - reinterpret_cast<std::byte*>(node) - header_size)};
+    size_t remaining{available - placement.required};
+
+    if (remaining < header_size + min_block) {
+      // tail is too small to split, absorb it so blocks tile the buffer
+      write_tags(node, available, allocated_flag | flags);
+      used += available;
+      out[carved++] = commit(node, placement.padding);
+
+      if (Node* next{next_block(node)}) {
+        next->tag |= previous_allocated_flag;
+      }
+      return carved;
+    }
+
+    write_tags(node, placement.required, allocated_flag | flags);
+    used += placement.required;
+    out[carved++] = commit(node, placement.padding);
+
+    // the next block starts right after, with this one allocated before it
+    Node* rest{reinterpret_cast<Node*>(reinterpret_cast<std::byte*>(node) +
+                                       header_size + placement.required)};
+    if (carved < out.size()) {
+      placement = place(rest, size, alignment);
+      if (remaining - header_size >= placement.required) {
+        node = rest;
+        flags = previous_allocated_flag;
+        continue;
+      }
+    }
+
+    write_tags(rest, remaining - header_size, previous_allocated_flag);
+    push_free(rest);
+    return carved;
+  }
+}
+
+template <size_t S, BufferType B, FitStrategy F, Tracking M, Concurrency C>
+std::byte* FreeListAllocator<S, B, F, M, C>::commit(Node* node,
+                                                    size_t padding) noexcept {
+  uintptr_t aligned{reinterpret_cast<uintptr_t>(node) + header_size +
+                    padding};
+  // adds padding pointer right before user data
+  *reinterpret_cast<size_t*>(aligned - sizeof(size_t)) = padding;
+
+  if constexpr (M == Tracking::DEBUG) {
+    uintptr_t ptr{
+        static_cast<uintptr_t>(aligned - reinterpret_cast<uintptr_t>(data))};
+    size_t offset{
+        static_cast<size_t>(reinterpret_cast<std::byte*>(node) - data)};
+    allocations[ptr] = {offset, size_of(node)};
   } else {
-    previous->next = next;
+    // and at the start of the padding, so get_state() can find user data
+    *reinterpret_cast<size_t*>(reinterpret_cast<std::byte*>(node) +
+                               header_size) = padding;
+  }
+
+  return reinterpret_cast<std::byte*>(aligned);
+}
+
+template <size_t S, BufferType B, FitStrategy F, Tracking M, Concurrency C>
+bool FreeListAllocator<S, B, F, M, C>::tree_less(const Node* lhs,
+                                                 const Node* rhs) noexcept {
+  // addresses break ties, so every free block has a unique key
+  size_t lhs_size{size_of(lhs)};
+  size_t rhs_size{size_of(rhs)};
+  return lhs_size < rhs_size || (lhs_size == rhs_size && lhs < rhs);
+}
+
+template <size_t S, BufferType B, FitStrategy F, Tracking M, Concurrency C>
+size_t FreeListAllocator<S, B, F, M, C>::tree_priority(
+    const Node* node) noexcept {
+  // hashed from the address, so priorities need no storage in the block
+  return static_cast<size_t>(reinterpret_cast<uintptr_t>(node) *
+                             static_cast<uintptr_t>(0x9E3779B97F4A7C15ull));
+}
+
+template <size_t S, BufferType B, FitStrategy F, Tracking M, Concurrency C>
+Node* FreeListAllocator<S, B, F, M, C>::tree_lower_bound(
+    size_t size) const noexcept {
+  Node* best{};
+
+  Node* current{head};
+  while (current) {
+    if (size_of(current) >= size) {
+      best = current;
+      current = current->previous;
+    } else {
+      current = current->next;
+    }
   }
+
+  return best;
 }
 
-}  // namespace allocator
\ No newline at end of file
+}  // namespace allocator
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include "common.h"
+
+namespace allocator {
+
+// default source of chunks, the global heap
+struct HeapUpstream {
+  [[nodiscard]] std::byte* allocate(size_t size, size_t alignment) noexcept;
+  void deallocate(std::byte* ptr) noexcept;
+};
+
+// chunks are chained through a header at their start
+struct Chunk {
+  Chunk* next;
+  size_t size;  // including the header
+};
+
+// Upstream is HeapUpstream or any allocator with allocate(size, alignment),
+// such as a FreeListAllocator or BuddyAllocator. Chunks are only returned
+// to it if it has deallocate(ptr).
+template <typename Upstream = HeapUpstream, Retention R = Retention::LARGEST>
+class GrowableLinearAllocator {
+ public:
+  using upstream_type = Upstream;
+  static constexpr Retention retention = R;
+
+  // position to rewind() to, which releases everything allocated after it
+  struct Marker {
+    Chunk* oversized;
+    Chunk* current;
+    size_t offset;
+    size_t previous_offset;
+    size_t retired;
+  };
+
+  explicit GrowableLinearAllocator(size_t chunk_size)
+    requires(std::is_same_v<Upstream, HeapUpstream>);
+  explicit GrowableLinearAllocator(Upstream& upstream, size_t chunk_size);
+  ~GrowableLinearAllocator() noexcept;
+
+  GrowableLinearAllocator(const GrowableLinearAllocator&) = delete;
+  GrowableLinearAllocator& operator=(const GrowableLinearAllocator&) = delete;
+
+  GrowableLinearAllocator(GrowableLinearAllocator&&) = delete;
+  GrowableLinearAllocator& operator=(GrowableLinearAllocator&&) = delete;
+
+  [[nodiscard]] std::byte* allocate(size_t size, size_t alignment) noexcept;
+
+  // only within the chunk holding the last allocation
+  [[nodiscard]] std::byte* resize_last(std::byte* previous_memory,
+                                       size_t new_size,
+                                       size_t alignment) noexcept;
+
+  void reset() noexcept;
+
+  // releases allocations in LIFO order, markers must be rewound innermost
+  // first and are invalidated by rewinding past them or by reset()
+  Marker get_marker() const noexcept;
+  void rewind(Marker marker) noexcept;
+
+  // bytes handed out since the last reset(), and bytes held in chunks
+  size_t get_used() const noexcept;
+  size_t get_capacity() const noexcept;
+
+  //////////////////////
+  // type-safe helpers
+  //////////////////////
+  template <typename T>
+  [[nodiscard]] T* allocate(size_t count = 1) noexcept;
+
+  template <typename T, typename... Args>
+  [[nodiscard]] T* emplace(Args&&... args);
+
+  template <typename T>
+  void destroy(T* ptr) noexcept;
+
+ private:
+  static constexpr size_t header_size{
+      align_forward(sizeof(Chunk), alignof(std::max_align_t))};
+
+  static std::byte* data_of(Chunk* chunk) noexcept;
+  static size_t capacity_of(const Chunk* chunk) noexcept;
+
+  // offset of an allocation placed at the start of chunk, or SIZE_MAX
+  static size_t place(Chunk* chunk, size_t size, size_t alignment) noexcept;
+
+  std::byte* allocate_slow(size_t size, size_t alignment) noexcept;
+  Chunk* grow(size_t size) noexcept;
+  void release(Chunk* chunk) noexcept;
+  void release_oversized(Chunk* until) noexcept;
+
+  static inline HeapUpstream heap{};
+
+  Upstream* upstream;
+
+  // chunks in the order they are filled, current is the one being bumped
+  // and any after it are retained from earlier cycles
+  Chunk* head;
+  Chunk* current;
+  std::byte* data;
+  size_t capacity;
+  size_t offset;
+  size_t previous_offset;
+
+  // chunks holding a single oversized request each, most recent first,
+  // which are released by reset() or by rewinding past them
+  Chunk* oversized;
+
+  // bytes used this cycle outside the current chunk
+  size_t retired;
+  size_t reserved;
+  size_t next_size;
+};
+}  // namespace allocator
+
+#include "growable_linear_allocator.inl"
@@ -0,0 +1,351 @@
+#pragma once
+
+#include <algorithm>
+#include <memory>
+#include <new>
+#include <utility>
+
+#include "growable_linear_allocator.h"
+
+namespace allocator {
+inline std::byte* HeapUpstream::allocate(size_t size,
+                                         size_t alignment) noexcept {
+  // operator new only guarantees alignof(std::max_align_t)
+  if (alignment > alignof(std::max_align_t)) {
+    return nullptr;
+  }
+  return static_cast<std::byte*>(::operator new(size, std::nothrow));
+}
+
+inline void HeapUpstream::deallocate(std::byte* ptr) noexcept {
+  ::operator delete(ptr);
+}
+
+template <typename Upstream, Retention R>
+GrowableLinearAllocator<Upstream, R>::GrowableLinearAllocator(
+    size_t chunk_size)
+  requires(std::is_same_v<Upstream, HeapUpstream>)
+    : GrowableLinearAllocator(heap, chunk_size) {}
+
+template <typename Upstream, Retention R>
+GrowableLinearAllocator<Upstream, R>::GrowableLinearAllocator(
+    Upstream& upstream, size_t chunk_size)
+    : upstream(&upstream),
+      head(nullptr),
+      current(nullptr),
+      data(nullptr),
+      capacity(0),
+      offset(0),
+      previous_offset(0),
+      oversized(nullptr),
+      retired(0),
+      reserved(0),
+      next_size(std::max(chunk_size, header_size + 1)) {}
+
+template <typename Upstream, Retention R>
+GrowableLinearAllocator<Upstream, R>::~GrowableLinearAllocator() noexcept {
+  release_oversized(nullptr);
+  while (head) {
+    Chunk* next{head->next};
+    release(head);
+    head = next;
+  }
+}
+
+template <typename Upstream, Retention R>
+std::byte* GrowableLinearAllocator<Upstream, R>::allocate(
+    size_t size, size_t alignment) noexcept {
+  if (!is_valid_alignment(alignment)) {
+    return nullptr;
+  }
+
+  // aligns the address rather than the offset, as the LinearAllocator does
+  uintptr_t base{reinterpret_cast<uintptr_t>(data)};
+  size_t aligned{align_forward(base + offset, alignment) - base};
+  if (aligned < offset || aligned > capacity || size > capacity - aligned) {
+    return allocate_slow(size, alignment);
+  }
+
+  previous_offset = aligned;
+  offset = aligned + size;
+  return data + aligned;
+}
+
+template <typename Upstream, Retention R>
+std::byte* GrowableLinearAllocator<Upstream, R>::resize_last(
+    std::byte* previous_memory, size_t new_size, size_t alignment) noexcept {
+  if (!is_valid_alignment(alignment) || !current) {
+    return nullptr;
+  }
+
+  // verify pointer to previous allocation
+  uintptr_t base{reinterpret_cast<uintptr_t>(data)};
+  size_t previous_aligned{align_forward(base + previous_offset, alignment) -
+                          base};
+  if (data + previous_aligned != previous_memory) {
+    return nullptr;
+  }
+
+  // check fit
+  if (previous_aligned > capacity || new_size > capacity - previous_aligned) {
+    return nullptr;
+  }
+
+  // update and return same pointer
+  offset = previous_aligned + new_size;
+  return previous_memory;
+}
+
+template <typename Upstream, Retention R>
+void GrowableLinearAllocator<Upstream, R>::reset() noexcept {
+  // not kept, the next chunk size grows to the peak instead
+  release_oversized(nullptr);
+  if (!head) {
+    return;
+  }
+
+  if constexpr (R == Retention::LARGEST) {
+    Chunk* largest{head};
+    for (Chunk* chunk{head->next}; chunk; chunk = chunk->next) {
+      if (chunk->size > largest->size) {
+        largest = chunk;
+      }
+    }
+
+    for (Chunk* chunk{head}; chunk;) {
+      Chunk* next{chunk->next};
+      if (chunk != largest) {
+        release(chunk);
+      }
+      chunk = next;
+    }
+
+    largest->next = nullptr;
+    head = largest;
+  } else {
+    // chunks left untouched this cycle were not needed to reach its peak
+    Chunk* reached{current ? current : head};
+    for (Chunk* chunk{reached->next}; chunk;) {
+      Chunk* next{chunk->next};
+      release(chunk);
+      chunk = next;
+    }
+    reached->next = nullptr;
+
+    // moves the largest chunk to the front, so it is filled first
+    Chunk** largest{&head};
+    for (Chunk** link{&head->next}; *link; link = &(*link)->next) {
+      if ((*link)->size > (*largest)->size) {
+        largest = link;
+      }
+    }
+
+    Chunk* chunk{*largest};
+    *largest = chunk->next;
+    chunk->next = head;
+    head = chunk;
+  }
+
+  // a cycle that spilled across chunks fits in one the next time it grows,
+  // so a steady workload stops reaching the upstream
+  size_t used{get_used()};
+  if (used <= SIZE_MAX - header_size) {
+    next_size = std::max(next_size, header_size + used);
+  }
+
+  current = head;
+  data = data_of(head);
+  capacity = capacity_of(head);
+  offset = 0;
+  previous_offset = 0;
+  retired = 0;
+}
+
+template <typename Upstream, Retention R>
+typename GrowableLinearAllocator<Upstream, R>::Marker
+GrowableLinearAllocator<Upstream, R>::get_marker() const noexcept {
+  return {oversized, current, offset, previous_offset, retired};
+}
+
+template <typename Upstream, Retention R>
+void GrowableLinearAllocator<Upstream, R>::rewind(Marker marker) noexcept {
+  // chunks after the marked one stay for reuse
+  release_oversized(marker.oversized);
+
+  current = marker.current;
+  data = current ? data_of(current) : nullptr;
+  capacity = current ? capacity_of(current) : 0;
+  offset = marker.offset;
+  previous_offset = marker.previous_offset;
+  retired = marker.retired;
+}
+
+template <typename Upstream, Retention R>
+size_t GrowableLinearAllocator<Upstream, R>::get_used() const noexcept {
+  return retired + offset;
+}
+
+template <typename Upstream, Retention R>
+size_t GrowableLinearAllocator<Upstream, R>::get_capacity() const noexcept {
+  return reserved;
+}
+
+template <typename Upstream, Retention R>
+std::byte* GrowableLinearAllocator<Upstream, R>::data_of(
+    Chunk* chunk) noexcept {
+  return reinterpret_cast<std::byte*>(chunk) + header_size;
+}
+
+template <typename Upstream, Retention R>
+size_t GrowableLinearAllocator<Upstream, R>::capacity_of(
+    const Chunk* chunk) noexcept {
+  return chunk->size - header_size;
+}
+
+template <typename Upstream, Retention R>
+size_t GrowableLinearAllocator<Upstream, R>::place(Chunk* chunk, size_t size,
+                                                   size_t alignment) noexcept {
+  uintptr_t base{reinterpret_cast<uintptr_t>(data_of(chunk))};
+  size_t aligned{align_forward(base, alignment) - base};
+  size_t available{capacity_of(chunk)};
+
+  if (aligned > available || size > available - aligned) {
+    return SIZE_MAX;
+  }
+  return aligned;
+}
+
+template <typename Upstream, Retention R>
+std::byte* GrowableLinearAllocator<Upstream, R>::allocate_slow(
+    size_t size, size_t alignment) noexcept {
+  if (size > SIZE_MAX - header_size - alignment) {  // check uint overflow
+    return nullptr;
+  }
+  // padding never exceeds the alignment, so the request always fits
+  size_t required{header_size + size + alignment};
+
+  // a chunk retained from an earlier cycle is tried before growing
+  Chunk* next{current ? current->next : head};
+  if (next && place(next, size, alignment) == SIZE_MAX) {
+    next = nullptr;
+  }
+
+  // oversized requests get a chunk of their own, so the current chunk
+  // keeps being filled
+  if (!next && current && required > next_size) {
+    Chunk* chunk{grow(required)};
+    if (!chunk) {
+      return nullptr;
+    }
+
+    chunk->next = oversized;
+    oversized = chunk;
+
+    size_t aligned{place(chunk, size, alignment)};
+    retired += aligned + size;
+    return data_of(chunk) + aligned;
+  }
+
+  if (!next) {
+    next = grow(std::max(next_size, required));
+    if (!next) {
+      return nullptr;
+    }
+
+    // doubling keeps the number of chunks logarithmic in the peak
+    if (next_size <= SIZE_MAX / 2) {
+      next_size *= 2;
+    }
+
+    // inserted ahead of any retained chunks, which stay available
+    if (current) {
+      next->next = current->next;
+      current->next = next;
+    } else {
+      next->next = head;
+      head = next;
+    }
+  }
+
+  retired += offset;
+  current = next;
+  data = data_of(next);
+  capacity = capacity_of(next);
+
+  size_t aligned{place(next, size, alignment)};
+  previous_offset = aligned;
+  offset = aligned + size;
+  return data + aligned;
+}
+
+template <typename Upstream, Retention R>
+Chunk* GrowableLinearAllocator<Upstream, R>::grow(size_t size) noexcept {
+  std::byte* ptr{upstream->allocate(size, alignof(std::max_align_t))};
+  if (!ptr) {
+    return nullptr;
+  }
+
+  reserved += size;
+  return std::construct_at(reinterpret_cast<Chunk*>(ptr), nullptr, size);
+}
+
+template <typename Upstream, Retention R>
+void GrowableLinearAllocator<Upstream, R>::release_oversized(
+    Chunk* until) noexcept {
+  while (oversized != until) {
+    Chunk* next{oversized->next};
+    release(oversized);
+    oversized = next;
+  }
+}
+
+template <typename Upstream, Retention R>
+void GrowableLinearAllocator<Upstream, R>::release(Chunk* chunk) noexcept {
+  reserved -= chunk->size;
+
+  // upstreams without deallocate() reclaim chunks on their own reset()
+  if constexpr (requires(std::byte* p) { upstream->deallocate(p); }) {
+    upstream->deallocate(reinterpret_cast<std::byte*>(chunk));
+  }
+}
+
+//////////////////////
+// type-safe helpers
+//////////////////////
+
+template <typename Upstream, Retention R>
+template <typename T>
+T* GrowableLinearAllocator<Upstream, R>::allocate(size_t count) noexcept {
+  if (count > SIZE_MAX / sizeof(T)) {  // check uint overflow
+    return nullptr;
+  }
+
+  size_t size{sizeof(T) * count};
+  size_t alignment{alignof(T)};
+  return reinterpret_cast<T*>(allocate(size, alignment));
+}
+
+template <typename Upstream, Retention R>
+template <typename T, typename... Args>
+T* GrowableLinearAllocator<Upstream, R>::emplace(Args&&... args) {
+  size_t size{sizeof(T)};
+  size_t alignment{alignof(T)};
+
+  std::byte* ptr{allocate(size, alignment)};
+  if (!ptr) {
+    return nullptr;
+  }
+
+  return std::construct_at(reinterpret_cast<T*>(ptr),
+                           std::forward<Args>(args)...);
+}
+
+template <typename Upstream, Retention R>
+template <typename T>
+void GrowableLinearAllocator<Upstream, R>::destroy(T* ptr) noexcept {
+  // asymmetric, does not deallocate (only reset does)
+  if (ptr) {
+    std::destroy_at(ptr);
+  }
+}
+}  // namespace allocator
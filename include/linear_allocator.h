@@ -2,24 +2,45 @@
 
 #include <array>
 #include <cstddef>
+#include <span>
 #include <string>
 #include <type_traits>
 #include <unordered_map>
 
 #include "common.h"
+#include "mmap_buffer.h"
 
 namespace allocator {
-template <size_t S, BufferType B = BufferType::HEAP>
+template <size_t S, BufferType B = BufferType::HEAP,
+          Tracking M = Tracking::NONE>
 class LinearAllocator {
  public:
+  static constexpr size_t extent = S;
   static constexpr BufferType buffer_type = B;
+  static constexpr Tracking tracking = M;
+
+  // position to rewind() to, which releases everything allocated after it
+  struct Marker {
+    size_t offset;
+    size_t previous_offset;
+  };
 
   explicit LinearAllocator()
-    requires(S > 0 && B == BufferType::HEAP);
+    requires(S > 0 && S != dynamic_extent && B == BufferType::HEAP);
   explicit LinearAllocator()
-    requires(S > 0 && B == BufferType::STACK);
+    requires(S > 0 && S != dynamic_extent && B == BufferType::STACK);
   explicit LinearAllocator(std::array<std::byte, S>& buf)
-    requires(S > 0 && B == BufferType::EXTERNAL);
+    requires(S > 0 && S != dynamic_extent && B == BufferType::EXTERNAL);
+  explicit LinearAllocator(MapOptions options = {})
+    requires(S > 0 && S != dynamic_extent && B == BufferType::MMAP);
+
+  // capacity chosen at construction, with S = dynamic_extent
+  explicit LinearAllocator(size_t size)
+    requires(S == dynamic_extent && B == BufferType::HEAP);
+  explicit LinearAllocator(std::span<std::byte> buf)
+    requires(S == dynamic_extent && B == BufferType::EXTERNAL);
+  explicit LinearAllocator(size_t size, MapOptions options = {})
+    requires(S == dynamic_extent && B == BufferType::MMAP);
   ~LinearAllocator() noexcept;
 
   LinearAllocator(const LinearAllocator&) = delete;
@@ -30,12 +51,24 @@ class LinearAllocator {
 
   [[nodiscard]] std::byte* allocate(size_t size, size_t alignment) noexcept;
 
+  // up to count blocks of size bytes in a single bump, laid out as count
+  // calls to allocate() would. writes them to out and returns how many fit,
+  // which is less than count only when out or the buffer runs out
+  [[nodiscard]] size_t allocate_bulk(size_t count, size_t size,
+                                     size_t alignment,
+                                     std::span<std::byte*> out) noexcept;
+
   [[nodiscard]] std::byte* resize_last(std::byte* previous_memory,
                                        size_t new_size,
                                        size_t alignment) noexcept;
 
   void reset() noexcept;
 
+  // releases allocations in LIFO order, markers must be rewound innermost
+  // first and are invalidated by rewinding past them or by reset()
+  Marker get_marker() const noexcept;
+  void rewind(Marker marker) noexcept;
+
   std::string get_state() const noexcept;
 
   //////////////////////
@@ -59,8 +92,9 @@ class LinearAllocator {
   size_t offset;
   size_t previous_offset;
 
-  // for get_state()
-  std::unordered_map<uintptr_t, size_t> allocations;
+  // for get_state(), compiled out unless Tracking::DEBUG
+  [[no_unique_address]] tracking_map_t<M, std::unordered_map<uintptr_t, size_t>>
+      allocations;
 };
 }  // namespace allocator
 
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <algorithm>
+#include <cassert>
 #include <memory>
 #include <ranges>
 #include <utility>
@@ -9,27 +10,27 @@
 #include "linear_allocator.h"
 
 namespace allocator {
-template <size_t S, BufferType B>
-LinearAllocator<S, B>::LinearAllocator()
-  requires(S > 0 && B == BufferType::HEAP)
+template <size_t S, BufferType B, Tracking M>
+LinearAllocator<S, B, M>::LinearAllocator()
+  requires(S > 0 && S != dynamic_extent && B == BufferType::HEAP)
     : buffer(static_cast<std::byte*>(::operator new(S))),
       data(buffer),
       capacity(S),
       offset(0),
       previous_offset(0) {}
 
-template <size_t S, BufferType B>
-LinearAllocator<S, B>::LinearAllocator()
-  requires(S > 0 && B == BufferType::STACK)
+template <size_t S, BufferType B, Tracking M>
+LinearAllocator<S, B, M>::LinearAllocator()
+  requires(S > 0 && S != dynamic_extent && B == BufferType::STACK)
     : buffer(std::array<std::byte, S>{}),
       data(buffer.data()),
       capacity(S),
       offset(0),
       previous_offset(0) {}
 
-template <size_t S, BufferType B>
-LinearAllocator<S, B>::LinearAllocator(std::array<std::byte, S>& buf)
-  requires(S > 0 && B == BufferType::EXTERNAL)
+template <size_t S, BufferType B, Tracking M>
+LinearAllocator<S, B, M>::LinearAllocator(std::array<std::byte, S>& buf)
+  requires(S > 0 && S != dynamic_extent && B == BufferType::EXTERNAL)
     : buffer(buf.data()), offset(0), previous_offset(0) {
   // ensures buffer pointer is aligned
   data = reinterpret_cast<std::byte*>(align_forward(
@@ -37,20 +38,61 @@ LinearAllocator<S, B>::LinearAllocator(std::array<std::byte, S>& buf)
   capacity = S - (data - buf.data());
 }
 
-template <size_t S, BufferType B>
-LinearAllocator<S, B>::~LinearAllocator() noexcept {
+template <size_t S, BufferType B, Tracking M>
+LinearAllocator<S, B, M>::LinearAllocator(MapOptions options)
+  requires(S > 0 && S != dynamic_extent && B == BufferType::MMAP)
+    : buffer(map_buffer(S, options)),
+      data(buffer),
+      capacity(S),
+      offset(0),
+      previous_offset(0) {}
+
+template <size_t S, BufferType B, Tracking M>
+LinearAllocator<S, B, M>::LinearAllocator(size_t size)
+  requires(S == dynamic_extent && B == BufferType::HEAP)
+    : buffer(static_cast<std::byte*>(::operator new(size))),
+      data(buffer),
+      capacity(size),
+      offset(0),
+      previous_offset(0) {}
+
+template <size_t S, BufferType B, Tracking M>
+LinearAllocator<S, B, M>::LinearAllocator(std::span<std::byte> buf)
+  requires(S == dynamic_extent && B == BufferType::EXTERNAL)
+    : buffer(buf.data()), offset(0), previous_offset(0) {
+  // ensures buffer pointer is aligned
+  data = reinterpret_cast<std::byte*>(align_forward(
+      reinterpret_cast<size_t>(buf.data()), alignof(std::max_align_t)));
+  capacity = buf.size() - std::min<size_t>(data - buf.data(), buf.size());
+}
+
+template <size_t S, BufferType B, Tracking M>
+LinearAllocator<S, B, M>::LinearAllocator(size_t size, MapOptions options)
+  requires(S == dynamic_extent && B == BufferType::MMAP)
+    : buffer(map_buffer(size, options)),
+      data(buffer),
+      capacity(size),
+      offset(0),
+      previous_offset(0) {}
+
+template <size_t S, BufferType B, Tracking M>
+LinearAllocator<S, B, M>::~LinearAllocator() noexcept {
   if constexpr (B == BufferType::HEAP) {
     ::operator delete(buffer);
+  } else if constexpr (B == BufferType::MMAP) {
+    unmap_buffer(buffer, capacity);
   }
 }
 
-template <size_t S, BufferType B>
-std::byte* LinearAllocator<S, B>::allocate(size_t size,
+template <size_t S, BufferType B, Tracking M>
+std::byte* LinearAllocator<S, B, M>::allocate(size_t size,
                                            size_t alignment) noexcept {
   if (!is_valid_alignment(alignment)) {
     return nullptr;
   }
-  size_t aligned{align_forward(offset, alignment)};
+  // aligns the address rather than the offset, data may be less aligned
+  uintptr_t base{reinterpret_cast<uintptr_t>(data)};
+  size_t aligned{align_forward(base + offset, alignment) - base};
   if (aligned < offset) {  // check uint overflow
     return nullptr;
   }
@@ -63,12 +105,56 @@ std::byte* LinearAllocator<S, B>::allocate(size_t size,
   previous_offset = aligned;
   offset = new_offset;
 
-  allocations[aligned] = size;
+  if constexpr (M == Tracking::DEBUG) {
+    allocations[aligned] = size;
+  }
   return (data + aligned);
 }
 
-template <size_t S, BufferType B>
-std::byte* LinearAllocator<S, B>::resize_last(std::byte* previous_memory,
+template <size_t S, BufferType B, Tracking M>
+size_t LinearAllocator<S, B, M>::allocate_bulk(
+    size_t count, size_t size, size_t alignment,
+    std::span<std::byte*> out) noexcept {
+  if (!is_valid_alignment(alignment)) {
+    return 0;
+  }
+
+  uintptr_t base{reinterpret_cast<uintptr_t>(data)};
+  size_t aligned{align_forward(base + offset, alignment) - base};
+  if (aligned < offset || aligned > capacity || capacity - aligned < size) {
+    return 0;
+  }
+
+  // each block after the first starts a whole stride past the one before,
+  // so all of them stay aligned
+  size_t stride{align_forward(size, alignment)};
+  if (stride < size) {  // check uint overflow
+    return 0;
+  }
+
+  count = std::min(count, out.size());
+  if (stride > 0) {
+    count = std::min(count, (capacity - aligned - size) / stride + 1);
+  }
+  if (count == 0) {
+    return 0;
+  }
+
+  for (size_t i{}; i < count; ++i) {
+    out[i] = data + aligned + i * stride;
+    if constexpr (M == Tracking::DEBUG) {
+      allocations[aligned + i * stride] = size;
+    }
+  }
+
+  // resize_last() applies to the last block, as after the same allocate()s
+  previous_offset = aligned + (count - 1) * stride;
+  offset = previous_offset + size;
+  return count;
+}
+
+template <size_t S, BufferType B, Tracking M>
+std::byte* LinearAllocator<S, B, M>::resize_last(std::byte* previous_memory,
                                               size_t new_size,
                                               size_t alignment) noexcept {
   if (!is_valid_alignment(alignment)) {
@@ -76,7 +162,9 @@ std::byte* LinearAllocator<S, B>::resize_last(std::byte* previous_memory,
   }
 
   // verify pointer to previous allocation
-  size_t previous_aligned{align_forward(previous_offset, alignment)};
+  uintptr_t base{reinterpret_cast<uintptr_t>(data)};
+  size_t previous_aligned{align_forward(base + previous_offset, alignment) -
+                          base};
   if (data + previous_aligned != previous_memory) {
     return nullptr;
   }
@@ -87,50 +175,87 @@ std::byte* LinearAllocator<S, B>::resize_last(std::byte* previous_memory,
     return nullptr;
   }
 
-  allocations[previous_offset] = new_size;
+  if constexpr (M == Tracking::DEBUG) {
+    allocations[previous_offset] = new_size;
+  }
 
   // update and return same pointer
   offset = new_offset;
   return previous_memory;
 }
 
-template <size_t S, BufferType B>
-void LinearAllocator<S, B>::reset() noexcept {
+template <size_t S, BufferType B, Tracking M>
+void LinearAllocator<S, B, M>::reset() noexcept {
   previous_offset = 0;
   offset = 0;
-  allocations.clear();
+
+  if constexpr (M == Tracking::DEBUG) {
+    allocations.clear();
+  }
 }
 
-template <size_t S, BufferType B>
-std::string LinearAllocator<S, B>::get_state() const noexcept {
-  try {
-    std::vector<std::pair<uintptr_t, size_t>> pointers(allocations.begin(),
-                                                       allocations.end());
-    std::ranges::sort(pointers);
+template <size_t S, BufferType B, Tracking M>
+typename LinearAllocator<S, B, M>::Marker
+LinearAllocator<S, B, M>::get_marker() const noexcept {
+  return {offset, previous_offset};
+}
+
+template <size_t S, BufferType B, Tracking M>
+void LinearAllocator<S, B, M>::rewind(Marker marker) noexcept {
+  assert(marker.offset <= offset && "marker is past the current offset");
+
+  // restoring previous_offset lets resize_last() reach the allocation that
+  // was last when the marker was taken
+  offset = marker.offset;
+  previous_offset = marker.previous_offset;
+
+  if constexpr (M == Tracking::DEBUG) {
+    std::erase_if(allocations, [&](const auto& allocation) {
+      return allocation.first >= marker.offset;
+    });
+  }
+}
 
+template <size_t S, BufferType B, Tracking M>
+std::string LinearAllocator<S, B, M>::get_state() const noexcept {
+  try {
     std::string blocks{};
-    for (const auto& [start, size] : pointers) {
-      if (!blocks.empty()) {
-        blocks += ",";
+
+    if constexpr (M == Tracking::DEBUG) {
+      std::vector<std::pair<uintptr_t, size_t>> pointers(allocations.begin(),
+                                                         allocations.end());
+      std::ranges::sort(pointers);
+
+      for (const auto& [start, size] : pointers) {
+        if (!blocks.empty()) {
+          blocks += ",";
+        }
+        blocks += "{\"ptr\":" + std::to_string(start) +
+                  ",\"offset\":" + std::to_string(start) +
+                  ",\"size\":" + std::to_string(size) +
+                  ",\"header\":0,\"status\":\"used\"}";
       }
-      blocks += "{\"ptr\":" + std::to_string(start) +
-                ",\"offset\":" + std::to_string(start) +
-                ",\"size\":" + std::to_string(size) +
+    } else if (offset > 0) {
+      // individual allocations are not recoverable without headers,
+      // so the bumped region is reported as a single used block
+      blocks += "{\"ptr\":0,\"offset\":0,\"size\":" + std::to_string(offset) +
                 ",\"header\":0,\"status\":\"used\"}";
     }
 
-    if (offset < S) {
+    if (offset < capacity) {
       if (!blocks.empty()) {
         blocks += ",";
       }
       blocks += "{\"ptr\":null,\"offset\":" + std::to_string(offset) +
-                ",\"size\":" + std::to_string(S - offset) +
+                ",\"size\":" + std::to_string(capacity - offset) +
                 ",\"header\":0,\"status\":\"free\"}";
     }
 
-    return "{\"totalBytes\":" + std::to_string(S) + ",\"blocks\":[" + blocks +
+    return "{\"totalBytes\":" + std::to_string(capacity) +
+           ",\"blocks\":[" + blocks +
            "],\"metrics\":{\"used\":" + std::to_string(offset) +
-           ",\"free\":" + std::to_string(S - offset) + ",\"fragmentation\":0}}";
+           ",\"free\":" + std::to_string(capacity - offset) +
+           ",\"fragmentation\":0}}";
 
   } catch (...) {
     return {};
@@ -141,9 +266,9 @@ std::string LinearAllocator<S, B>::get_state() const noexcept {
 // type-safe helpers
 //////////////////////
 
-template <size_t S, BufferType B>
+template <size_t S, BufferType B, Tracking M>
 template <typename T>
-T* LinearAllocator<S, B>::allocate(size_t count) noexcept {
+T* LinearAllocator<S, B, M>::allocate(size_t count) noexcept {
   if (count > SIZE_MAX / sizeof(T)) {  // check uint overflow
     return nullptr;
   }
@@ -153,9 +278,9 @@ T* LinearAllocator<S, B>::allocate(size_t count) noexcept {
   return reinterpret_cast<T*>(allocate(size, alignment));
 }
 
-template <size_t S, BufferType B>
+template <size_t S, BufferType B, Tracking M>
 template <typename T, typename... Args>
-T* LinearAllocator<S, B>::emplace(Args&&... args) {
+T* LinearAllocator<S, B, M>::emplace(Args&&... args) {
   size_t size{sizeof(T)};
   size_t alignment{alignof(T)};
 
@@ -168,9 +293,9 @@ T* LinearAllocator<S, B>::emplace(Args&&... args) {
                            std::forward<Args>(args)...);
 }
 
-template <size_t S, BufferType B>
+template <size_t S, BufferType B, Tracking M>
 template <typename T>
-void LinearAllocator<S, B>::destroy(T* ptr) noexcept {
+void LinearAllocator<S, B, M>::destroy(T* ptr) noexcept {
   // asymmetric, does not deallocate (only reset does)
   if (ptr) {
     std::destroy_at(ptr);
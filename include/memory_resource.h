@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstddef>
+#include <memory_resource>
+
+#include "common.h"
+
+namespace allocator {
+
+// Allocator is a LinearAllocator, FreeListAllocator or BuddyAllocator,
+// owned by the caller, exposed to std::pmr containers. Allocation failure
+// throws std::bad_alloc, as std::pmr::memory_resource requires.
+// deallocation is a no-op for allocators without one, as with
+// std::pmr::monotonic_buffer_resource.
+template <typename Allocator>
+class MemoryResource : public std::pmr::memory_resource {
+ public:
+  explicit MemoryResource(Allocator& allocator) noexcept;
+  ~MemoryResource() override = default;
+
+  MemoryResource(const MemoryResource&) = delete;
+  MemoryResource& operator=(const MemoryResource&) = delete;
+
+  Allocator& get_allocator() const noexcept;
+
+ private:
+  void* do_allocate(size_t bytes, size_t alignment) override;
+  void do_deallocate(void* ptr, size_t bytes, size_t alignment) override;
+  bool do_is_equal(
+      const std::pmr::memory_resource& other) const noexcept override;
+
+  Allocator& allocator;
+};
+}  // namespace allocator
+
+#include "memory_resource.inl"
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <new>
+
+#include "memory_resource.h"
+
+namespace allocator {
+template <typename Allocator>
+MemoryResource<Allocator>::MemoryResource(Allocator& allocator) noexcept
+    : allocator(allocator) {}
+
+template <typename Allocator>
+Allocator& MemoryResource<Allocator>::get_allocator() const noexcept {
+  return allocator;
+}
+
+template <typename Allocator>
+void* MemoryResource<Allocator>::do_allocate(size_t bytes, size_t alignment) {
+  std::byte* ptr{allocator.allocate(bytes, alignment)};
+  if (!ptr) {
+    throw std::bad_alloc{};
+  }
+
+  return ptr;
+}
+
+template <typename Allocator>
+void MemoryResource<Allocator>::do_deallocate(void* ptr, size_t bytes,
+                                              size_t alignment) {
+  // the size and alignment given back spare the allocator its own lookup,
+  // and only reset() reclaims memory from allocators without deallocate()
+  if constexpr (requires(std::byte* p) {
+                  allocator.deallocate(p, bytes, alignment);
+                }) {
+    allocator.deallocate(static_cast<std::byte*>(ptr), bytes, alignment);
+  } else if constexpr (requires(std::byte* p) { allocator.deallocate(p); }) {
+    allocator.deallocate(static_cast<std::byte*>(ptr));
+  }
+}
+
+template <typename Allocator>
+bool MemoryResource<Allocator>::do_is_equal(
+    const std::pmr::memory_resource& other) const noexcept {
+  // resources over the same allocator can free each other's memory
+  const auto* resource{dynamic_cast<const MemoryResource*>(&other)};
+  return resource && &resource->allocator == &allocator;
+}
+
+}  // namespace allocator
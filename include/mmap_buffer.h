@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef>
+
+#include "common.h"
+
+namespace allocator {
+
+// the huge page size on x86-64 and most aarch64 kernels, also the alignment
+// of every mapped buffer so that it can be backed by huge pages
+inline constexpr size_t huge_page_size{2 * 1024 * 1024};
+
+// HugePages::TRANSPARENT advises the kernel to back the buffer with
+// transparent huge pages. HugePages::EXPLICIT maps it from the reserved
+// hugetlbfs pool instead, falling back to transparent huge pages when the
+// pool is empty or the buffer is smaller than a huge page
+enum class HugePages { NONE, TRANSPARENT, EXPLICIT };
+
+struct MapOptions {
+  HugePages huge_pages{HugePages::TRANSPARENT};
+  // faults every page in up front, rather than on first touch
+  bool populate{false};
+};
+
+// bytes actually mapped for a buffer of size bytes, rounded up to whole
+// pages, or to whole huge pages once it spans at least one
+size_t mapped_length(size_t size) noexcept;
+
+// throws std::bad_alloc if the mapping fails, as ::operator new would
+[[nodiscard]] std::byte* map_buffer(size_t size, MapOptions options);
+void unmap_buffer(std::byte* buffer, size_t size) noexcept;
+}  // namespace allocator
+
+#include "mmap_buffer.inl"
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <sys/mman.h>
+
+#include <cstdint>
+#include <new>
+
+#include "mmap_buffer.h"
+
+namespace allocator {
+inline size_t mapped_length(size_t size) noexcept {
+  return align_forward(size,
+                       size >= huge_page_size ? huge_page_size : page_size);
+}
+
+inline std::byte* map_buffer(size_t size, MapOptions options) {
+  size_t length{mapped_length(size)};
+  int protection{PROT_READ | PROT_WRITE};
+  int flags{MAP_PRIVATE | MAP_ANONYMOUS};
+
+#ifdef MAP_HUGETLB
+  if (options.huge_pages == HugePages::EXPLICIT &&
+      length % huge_page_size == 0) {
+    int huge_flags{flags | MAP_HUGETLB};
+#ifdef MAP_POPULATE
+    if (options.populate) {
+      huge_flags |= MAP_POPULATE;
+    }
+#endif
+    // hugetlb mappings are always aligned to the huge page size
+    void* ptr{::mmap(nullptr, length, protection, huge_flags, -1, 0)};
+    if (ptr != MAP_FAILED) {
+      return static_cast<std::byte*>(ptr);
+    }
+  }
+#endif
+
+  // over-reserves address space so the start can be moved up to a huge
+  // page boundary, then returns the unused head and tail
+  if (length > SIZE_MAX - huge_page_size) {  // check uint overflow
+    throw std::bad_alloc{};
+  }
+  size_t reserved{length + huge_page_size};
+  void* ptr{::mmap(nullptr, reserved, protection, flags, -1, 0)};
+  if (ptr == MAP_FAILED) {
+    throw std::bad_alloc{};
+  }
+
+  uintptr_t start{reinterpret_cast<uintptr_t>(ptr)};
+  uintptr_t aligned{align_forward(start, huge_page_size)};
+  if (aligned > start) {
+    ::munmap(ptr, aligned - start);
+  }
+  if (size_t tail{start + reserved - (aligned + length)}; tail > 0) {
+    ::munmap(reinterpret_cast<void*>(aligned + length), tail);
+  }
+
+  std::byte* buffer{reinterpret_cast<std::byte*>(aligned)};
+
+#ifdef MADV_HUGEPAGE
+  if (options.huge_pages != HugePages::NONE) {
+    ::madvise(buffer, length, MADV_HUGEPAGE);
+  }
+#endif
+
+  if (options.populate) {
+#ifdef MADV_POPULATE_WRITE
+    if (::madvise(buffer, length, MADV_POPULATE_WRITE) == 0) {
+      return buffer;
+    }
+#endif
+    // older kernels, touching one byte per page faults it in
+    for (size_t offset{}; offset < length; offset += page_size) {
+      buffer[offset] = std::byte{0};
+    }
+  }
+
+  return buffer;
+}
+
+inline void unmap_buffer(std::byte* buffer, size_t size) noexcept {
+  ::munmap(buffer, mapped_length(size));
+}
+}  // namespace allocator
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <type_traits>
+
+#include "common.h"
+#include "mmap_buffer.h"
+#include "remote_free_list.h"
+
+namespace allocator {
+
+struct Slot {
+  Slot* next;
+};
+
+// with Concurrency::OWNER, any thread may deallocate, while allocate(),
+// reset() and get_state() are left to the owning thread
+template <size_t BlockSize, size_t Count, BufferType B = BufferType::HEAP,
+          Concurrency C = Concurrency::NONE>
+class PoolAllocator {
+  static_assert(C != Concurrency::PER_LEVEL,
+                "a pool has no levels, use Concurrency::OWNER");
+
+ public:
+  static constexpr BufferType buffer_type = B;
+  static constexpr Concurrency concurrency = C;
+
+  // largest alignment an object of BlockSize bytes can require
+  static constexpr size_t block_alignment{
+      std::max(std::min(BlockSize & (~BlockSize + 1),
+                        alignof(std::max_align_t)),
+               alignof(Slot))};
+  static constexpr size_t stride{
+      align_forward(std::max(BlockSize, sizeof(Slot)), block_alignment)};
+  static constexpr size_t S{Count == dynamic_extent ? dynamic_extent
+                                                     : stride * Count};
+
+  explicit PoolAllocator()
+    requires(BlockSize > 0 && Count > 0 && Count != dynamic_extent &&
+             B == BufferType::HEAP);
+  explicit PoolAllocator()
+    requires(BlockSize > 0 && Count > 0 && Count != dynamic_extent &&
+             B == BufferType::STACK);
+  explicit PoolAllocator(std::array<std::byte, S>& buf)
+    requires(BlockSize > 0 && Count > 0 && Count != dynamic_extent &&
+             B == BufferType::EXTERNAL);
+  explicit PoolAllocator(MapOptions options = {})
+    requires(BlockSize > 0 && Count > 0 && Count != dynamic_extent &&
+             B == BufferType::MMAP);
+
+  // block count chosen at construction, with Count = dynamic_extent
+  explicit PoolAllocator(size_t blocks)
+    requires(BlockSize > 0 && Count == dynamic_extent &&
+             B == BufferType::HEAP);
+  explicit PoolAllocator(std::span<std::byte> buf)
+    requires(BlockSize > 0 && Count == dynamic_extent &&
+             B == BufferType::EXTERNAL);
+  explicit PoolAllocator(size_t blocks, MapOptions options = {})
+    requires(BlockSize > 0 && Count == dynamic_extent &&
+             B == BufferType::MMAP);
+  ~PoolAllocator() noexcept;
+
+  PoolAllocator(const PoolAllocator&) = delete;
+  PoolAllocator& operator=(const PoolAllocator&) = delete;
+
+  PoolAllocator(PoolAllocator&&) = delete;
+  PoolAllocator& operator=(PoolAllocator&&) = delete;
+
+  [[nodiscard]] std::byte* allocate() noexcept;
+  void deallocate(std::byte* ptr) noexcept;
+  void reset() noexcept;
+
+  // hands the allocator to the calling thread, while no other uses it
+  void set_owner() noexcept
+    requires(C == Concurrency::OWNER);
+
+  std::string get_state() const noexcept;
+
+  size_t get_used() const noexcept;
+  size_t get_free() const noexcept;
+
+  //////////////////////
+  // type-safe helpers
+  //////////////////////
+  template <typename T>
+  [[nodiscard]] T* allocate() noexcept
+    requires(sizeof(T) <= stride && alignof(T) <= block_alignment);
+
+  template <typename T>
+  void deallocate(T* ptr) noexcept;
+
+  template <typename T, typename... Args>
+  [[nodiscard]] T* emplace(Args&&... args)
+    requires(sizeof(T) <= stride && alignof(T) <= block_alignment);
+
+  template <typename T>
+  void destroy(T* ptr) noexcept;
+
+ private:
+  // deallocate() once the block is known to be this thread's to free
+  void release(std::byte* ptr) noexcept;
+
+  alignas(std::max_align_t)
+      std::conditional_t<B == BufferType::STACK, std::array<std::byte, S>,
+                         std::byte*> buffer;
+  std::byte* data;
+  size_t count;
+  size_t used;
+
+  // blocks below watermark have been handed out at least once, blocks
+  // above it are carved lazily so construction and reset() stay O(1)
+  size_t watermark;
+  Slot* head;
+
+  // blocks freed by other threads, compiled out unless Concurrency::OWNER
+  [[no_unique_address]] remote_free_list_t<C> remote;
+};
+}  // namespace allocator
+
+#include "pool_allocator.inl"
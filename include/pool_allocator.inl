@@ -0,0 +1,264 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "pool_allocator.h"
+
+namespace allocator {
+template <size_t BlockSize, size_t Count, BufferType B, Concurrency C>
+PoolAllocator<BlockSize, Count, B, C>::PoolAllocator()
+  requires(BlockSize > 0 && Count > 0 && Count != dynamic_extent &&
+           B == BufferType::HEAP)
+    : buffer(static_cast<std::byte*>(::operator new(S))),
+      data(buffer),
+      count(Count),
+      used(0),
+      watermark(0),
+      head(nullptr) {}
+
+template <size_t BlockSize, size_t Count, BufferType B, Concurrency C>
+PoolAllocator<BlockSize, Count, B, C>::PoolAllocator()
+  requires(BlockSize > 0 && Count > 0 && Count != dynamic_extent &&
+           B == BufferType::STACK)
+    : buffer(std::array<std::byte, S>{}),
+      data(buffer.data()),
+      count(Count),
+      used(0),
+      watermark(0),
+      head(nullptr) {}
+
+template <size_t BlockSize, size_t Count, BufferType B, Concurrency C>
+PoolAllocator<BlockSize, Count, B, C>::PoolAllocator(
+    std::array<std::byte, S>& buf)
+  requires(BlockSize > 0 && Count > 0 && Count != dynamic_extent &&
+           B == BufferType::EXTERNAL)
+    : buffer(buf.data()), used(0), watermark(0), head(nullptr) {
+  // ensures buffer pointer is aligned, which may cost the last block
+  data = reinterpret_cast<std::byte*>(
+      align_forward(reinterpret_cast<size_t>(buf.data()), block_alignment));
+  count = (S - (data - buf.data())) / stride;
+}
+
+template <size_t BlockSize, size_t Count, BufferType B, Concurrency C>
+PoolAllocator<BlockSize, Count, B, C>::PoolAllocator(MapOptions options)
+  requires(BlockSize > 0 && Count > 0 && Count != dynamic_extent &&
+           B == BufferType::MMAP)
+    : buffer(map_buffer(S, options)),
+      data(buffer),
+      count(Count),
+      used(0),
+      watermark(0),
+      head(nullptr) {}
+
+template <size_t BlockSize, size_t Count, BufferType B, Concurrency C>
+PoolAllocator<BlockSize, Count, B, C>::PoolAllocator(size_t blocks)
+  requires(BlockSize > 0 && Count == dynamic_extent && B == BufferType::HEAP)
+    : buffer(static_cast<std::byte*>(::operator new(stride * blocks))),
+      data(buffer),
+      count(blocks),
+      used(0),
+      watermark(0),
+      head(nullptr) {}
+
+template <size_t BlockSize, size_t Count, BufferType B, Concurrency C>
+PoolAllocator<BlockSize, Count, B, C>::PoolAllocator(std::span<std::byte> buf)
+  requires(BlockSize > 0 && Count == dynamic_extent &&
+           B == BufferType::EXTERNAL)
+    : buffer(buf.data()), used(0), watermark(0), head(nullptr) {
+  // ensures buffer pointer is aligned, which may cost the last block
+  data = reinterpret_cast<std::byte*>(
+      align_forward(reinterpret_cast<size_t>(buf.data()), block_alignment));
+  count = (buf.size() - std::min<size_t>(data - buf.data(), buf.size())) /
+          stride;
+}
+
+template <size_t BlockSize, size_t Count, BufferType B, Concurrency C>
+PoolAllocator<BlockSize, Count, B, C>::PoolAllocator(size_t blocks,
+                                                     MapOptions options)
+  requires(BlockSize > 0 && Count == dynamic_extent && B == BufferType::MMAP)
+    : buffer(map_buffer(stride * blocks, options)),
+      data(buffer),
+      count(blocks),
+      used(0),
+      watermark(0),
+      head(nullptr) {}
+
+template <size_t BlockSize, size_t Count, BufferType B, Concurrency C>
+PoolAllocator<BlockSize, Count, B, C>::~PoolAllocator() noexcept {
+  if constexpr (B == BufferType::HEAP) {
+    ::operator delete(buffer);
+  } else if constexpr (B == BufferType::MMAP) {
+    unmap_buffer(buffer, stride * count);
+  }
+}
+
+template <size_t BlockSize, size_t Count, BufferType B, Concurrency C>
+std::byte* PoolAllocator<BlockSize, Count, B, C>::allocate() noexcept {
+  if constexpr (C == Concurrency::OWNER) {
+    // blocks other threads freed since the last call are reused first
+    remote.drain([this](std::byte* ptr) { release(ptr); });
+  }
+
+  std::byte* block{};
+
+  if (head != nullptr) {
+    block = reinterpret_cast<std::byte*>(head);
+    head = head->next;
+  } else if (watermark < count) {
+    block = data + watermark * stride;
+    ++watermark;
+  } else {
+    return nullptr;
+  }
+
+  ++used;
+  return block;
+}
+
+template <size_t BlockSize, size_t Count, BufferType B, Concurrency C>
+void PoolAllocator<BlockSize, Count, B, C>::deallocate(
+    std::byte* ptr) noexcept {
+  if (!ptr) {
+    return;
+  }
+
+  if constexpr (C == Concurrency::OWNER) {
+    if (!remote.is_owner()) {
+      remote.push(ptr);
+      return;
+    }
+  }
+
+  release(ptr);
+}
+
+template <size_t BlockSize, size_t Count, BufferType B, Concurrency C>
+void PoolAllocator<BlockSize, Count, B, C>::release(std::byte* ptr) noexcept {
+  assert(ptr >= data && ptr < data + watermark * stride &&
+         "pointer is out of bounds");
+  assert((ptr - data) % stride == 0 && "pointer is not a block boundary");
+
+  Slot* slot{reinterpret_cast<Slot*>(ptr)};
+  slot->next = head;
+  head = slot;
+
+  --used;
+}
+
+template <size_t BlockSize, size_t Count, BufferType B, Concurrency C>
+void PoolAllocator<BlockSize, Count, B, C>::reset() noexcept {
+  if constexpr (C == Concurrency::OWNER) {
+    // reclaimed along with everything else
+    remote.drain([](std::byte*) {});
+  }
+
+  used = 0;
+  watermark = 0;
+  head = nullptr;
+}
+
+template <size_t BlockSize, size_t Count, BufferType B, Concurrency C>
+void PoolAllocator<BlockSize, Count, B, C>::set_owner() noexcept
+  requires(C == Concurrency::OWNER)
+{
+  remote.set_owner();
+}
+
+template <size_t BlockSize, size_t Count, BufferType B, Concurrency C>
+std::string PoolAllocator<BlockSize, Count, B, C>::get_state() const noexcept {
+  try {
+    std::vector<bool> free(watermark, false);
+    for (Slot* slot{head}; slot != nullptr; slot = slot->next) {
+      free[(reinterpret_cast<std::byte*>(slot) - data) / stride] = true;
+    }
+
+    std::string blocks{};
+    for (size_t i{}; i < watermark; ++i) {
+      size_t start{i * stride};
+
+      if (!blocks.empty()) {
+        blocks += ",";
+      }
+      blocks += "{\"ptr\":" + (free[i] ? "null" : std::to_string(start)) +
+                ",\"offset\":" + std::to_string(start) +
+                ",\"size\":" + std::to_string(stride) +
+                ",\"header\":0,\"status\":\"" + (free[i] ? "free" : "used") +
+                "\"}";
+    }
+
+    // blocks never handed out are reported as a single free region
+    if (watermark < count) {
+      if (!blocks.empty()) {
+        blocks += ",";
+      }
+      blocks += "{\"ptr\":null,\"offset\":" +
+                std::to_string(watermark * stride) +
+                ",\"size\":" + std::to_string((count - watermark) * stride) +
+                ",\"header\":0,\"status\":\"free\"}";
+    }
+
+    return "{\"totalBytes\":" + std::to_string(count * stride) +
+           ",\"blockSize\":" + std::to_string(stride) + ",\"blocks\":[" +
+           blocks + "],\"metrics\":{\"used\":" + std::to_string(get_used()) +
+           ",\"free\":" + std::to_string(get_free()) + ",\"fragmentation\":0}}";
+
+  } catch (...) {
+    return {};
+  }
+}
+
+template <size_t BlockSize, size_t Count, BufferType B, Concurrency C>
+size_t PoolAllocator<BlockSize, Count, B, C>::get_used() const noexcept {
+  return used * stride;
+}
+
+template <size_t BlockSize, size_t Count, BufferType B, Concurrency C>
+size_t PoolAllocator<BlockSize, Count, B, C>::get_free() const noexcept {
+  return (count - used) * stride;
+}
+
+//////////////////////
+// type-safe helpers
+//////////////////////
+
+template <size_t BlockSize, size_t Count, BufferType B, Concurrency C>
+template <typename T>
+T* PoolAllocator<BlockSize, Count, B, C>::allocate() noexcept
+  requires(sizeof(T) <= stride && alignof(T) <= block_alignment)
+{
+  return reinterpret_cast<T*>(allocate());
+}
+
+template <size_t BlockSize, size_t Count, BufferType B, Concurrency C>
+template <typename T>
+void PoolAllocator<BlockSize, Count, B, C>::deallocate(T* ptr) noexcept {
+  deallocate(reinterpret_cast<std::byte*>(ptr));
+}
+
+template <size_t BlockSize, size_t Count, BufferType B, Concurrency C>
+template <typename T, typename... Args>
+T* PoolAllocator<BlockSize, Count, B, C>::emplace(Args&&... args)
+  requires(sizeof(T) <= stride && alignof(T) <= block_alignment)
+{
+  std::byte* ptr{allocate()};
+  if (!ptr) {
+    return nullptr;
+  }
+
+  return std::construct_at(reinterpret_cast<T*>(ptr),
+                           std::forward<Args>(args)...);
+}
+
+template <size_t BlockSize, size_t Count, BufferType B, Concurrency C>
+template <typename T>
+void PoolAllocator<BlockSize, Count, B, C>::destroy(T* ptr) noexcept {
+  // asymmetric, does not deallocate (only deallocate or reset does)
+  if (ptr) {
+    std::destroy_at(ptr);
+  }
+}
+}  // namespace allocator
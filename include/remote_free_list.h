@@ -0,0 +1,53 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <type_traits>
+
+#include "common.h"
+
+namespace allocator {
+
+// blocks freed by threads other than the owner of an allocator that is not
+// thread-safe. they are pushed onto a lock-free stack linked through the
+// blocks themselves, and the owner takes the whole stack at once and frees
+// each block on its own thread
+class RemoteFreeList {
+ public:
+  // the constructing thread is the owner
+  RemoteFreeList() noexcept;
+
+  RemoteFreeList(const RemoteFreeList&) = delete;
+  RemoteFreeList& operator=(const RemoteFreeList&) = delete;
+
+  bool is_owner() const noexcept;
+  // must not run alongside any other call
+  void set_owner() noexcept;
+
+  // any thread, the block must have room for a pointer
+  void push(std::byte* ptr) noexcept;
+
+  // owner only, calls release for every block pushed so far
+  template <typename Release>
+  void drain(Release&& release) noexcept;
+
+ private:
+  struct Link {
+    Link* next;
+  };
+
+  std::thread::id owner;
+  // written by every remote thread, kept off the owner's lines
+  alignas(cache_line_size) std::atomic<Link*> head;
+};
+
+// stand-in for the remote free list when only one thread is allowed
+struct Unshared {};
+
+template <Concurrency C>
+using remote_free_list_t =
+    std::conditional_t<C == Concurrency::OWNER, RemoteFreeList, Unshared>;
+}  // namespace allocator
+
+#include "remote_free_list.inl"
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <utility>
+
+#include "remote_free_list.h"
+
+namespace allocator {
+inline RemoteFreeList::RemoteFreeList() noexcept
+    : owner(std::this_thread::get_id()), head(nullptr) {}
+
+inline bool RemoteFreeList::is_owner() const noexcept {
+  return std::this_thread::get_id() == owner;
+}
+
+inline void RemoteFreeList::set_owner() noexcept {
+  owner = std::this_thread::get_id();
+}
+
+inline void RemoteFreeList::push(std::byte* ptr) noexcept {
+  Link* link{reinterpret_cast<Link*>(ptr)};
+  link->next = head.load(std::memory_order_relaxed);
+
+  // release, so whatever the thread wrote to the block is visible to the
+  // owner before it hands the block out again
+  while (!head.compare_exchange_weak(link->next, link,
+                                     std::memory_order_release,
+                                     std::memory_order_relaxed)) {
+  }
+}
+
+template <typename Release>
+void RemoteFreeList::drain(Release&& release) noexcept {
+  // a plain load first, so the owner only writes the shared line when
+  // there is something to take
+  if (!head.load(std::memory_order_relaxed)) {
+    return;
+  }
+
+  // the owner takes the whole stack, so no link is ever popped while
+  // another thread reads it and ABA cannot happen
+  Link* link{head.exchange(nullptr, std::memory_order_acquire)};
+  while (link) {
+    Link* next{link->next};
+    release(reinterpret_cast<std::byte*>(link));
+    link = next;
+  }
+}
+}  // namespace allocator
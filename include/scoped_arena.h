@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstddef>
+
+#include "common.h"
+
+namespace allocator {
+
+// RAII guard over a caller-owned LinearAllocator or GrowableLinearAllocator,
+// which rewinds it on destruction to where it was on construction. guards
+// must be destroyed in LIFO order, which nesting them in scopes ensures.
+// destructors of objects allocated within the scope are not run.
+template <typename Allocator>
+class ScopedArena {
+ public:
+  explicit ScopedArena(Allocator& allocator) noexcept;
+  ~ScopedArena() noexcept;
+
+  ScopedArena(const ScopedArena&) = delete;
+  ScopedArena& operator=(const ScopedArena&) = delete;
+
+  ScopedArena(ScopedArena&&) = delete;
+  ScopedArena& operator=(ScopedArena&&) = delete;
+
+  // releases everything allocated within the scope so far
+  void rewind() noexcept;
+
+  Allocator& get_allocator() const noexcept;
+
+ private:
+  Allocator& allocator;
+  typename Allocator::Marker marker;
+};
+}  // namespace allocator
+
+#include "scoped_arena.inl"
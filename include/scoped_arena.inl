@@ -0,0 +1,25 @@
+#pragma once
+
+#include "scoped_arena.h"
+
+namespace allocator {
+template <typename Allocator>
+ScopedArena<Allocator>::ScopedArena(Allocator& allocator) noexcept
+    : allocator(allocator), marker(allocator.get_marker()) {}
+
+template <typename Allocator>
+ScopedArena<Allocator>::~ScopedArena() noexcept {
+  allocator.rewind(marker);
+}
+
+template <typename Allocator>
+void ScopedArena<Allocator>::rewind() noexcept {
+  allocator.rewind(marker);
+}
+
+template <typename Allocator>
+Allocator& ScopedArena<Allocator>::get_allocator() const noexcept {
+  return allocator;
+}
+
+}  // namespace allocator
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+#include "common.h"
+#include "mmap_buffer.h"
+
+namespace allocator {
+
+// splits one buffer into N shards, each a FreeListAllocator or
+// BuddyAllocator over its own slice with a lock of its own. threads
+// allocate from the shard of the CPU they run on, and a block is always
+// freed to the shard whose slice holds it, found from its address
+template <typename Backend, size_t N = 8, BufferType B = BufferType::HEAP,
+          Affinity A = Affinity::CPU>
+class ShardedAllocator {
+ public:
+  static constexpr size_t shard_count = N;
+  static constexpr BufferType buffer_type = B;
+  static constexpr Affinity affinity = A;
+
+  // size is the capacity of all shards together, each gets an equal slice.
+  // over BuddyAllocator shards each slice is a power of 2, so with N or the
+  // size not one, up to half of the buffer goes unused
+  explicit ShardedAllocator(size_t size)
+    requires(N > 0 && B == BufferType::HEAP &&
+             std::is_constructible_v<Backend, std::span<std::byte>>);
+  explicit ShardedAllocator(std::span<std::byte> buf)
+    requires(N > 0 && B == BufferType::EXTERNAL &&
+             std::is_constructible_v<Backend, std::span<std::byte>>);
+  explicit ShardedAllocator(size_t size, MapOptions options = {})
+    requires(N > 0 && B == BufferType::MMAP &&
+             std::is_constructible_v<Backend, std::span<std::byte>>);
+  ~ShardedAllocator() noexcept;
+
+  ShardedAllocator(const ShardedAllocator&) = delete;
+  ShardedAllocator& operator=(const ShardedAllocator&) = delete;
+
+  ShardedAllocator(ShardedAllocator&&) = delete;
+  ShardedAllocator& operator=(ShardedAllocator&&) = delete;
+
+  // thread-safe, falls back to the other shards when the home one is full
+  [[nodiscard]] std::byte* allocate(size_t size, size_t alignment) noexcept;
+  void deallocate(std::byte* ptr) noexcept;
+  void reset() noexcept;
+
+  // shard the calling thread allocates from, and the one owning ptr
+  size_t get_home_shard() const noexcept;
+  size_t get_shard(const std::byte* ptr) const noexcept;
+
+  size_t get_used() const noexcept;
+  size_t get_free() const noexcept;
+
+  //////////////////////
+  // type-safe helpers
+  //////////////////////
+  template <typename T>
+  [[nodiscard]] T* allocate(size_t count = 1) noexcept;
+
+  template <typename T>
+  void deallocate(T* ptr) noexcept;
+
+  template <typename T, typename... Args>
+  [[nodiscard]] T* emplace(Args&&... args);
+
+  template <typename T>
+  void destroy(T* ptr) noexcept;
+
+ private:
+  // on a line of its own, so threads on different shards never share one
+  struct alignas(cache_line_size) Shard {
+    explicit Shard(std::span<std::byte> slice) : backend(slice) {}
+
+    mutable std::mutex mutex;
+    Backend backend;
+  };
+
+  // shards are neither copyable nor movable, so the array is built in place
+  template <size_t... I>
+  std::array<Shard, N> make_shards(std::index_sequence<I...>);
+
+  static std::byte* align_data(std::byte* ptr) noexcept;
+  static size_t slice_size(size_t capacity) noexcept;
+
+  std::byte* buffer;
+  std::byte* data;
+  size_t capacity;
+  // slices start on cache lines, and over BuddyAllocator shards are a power
+  // of 2, so the tail past N of them goes unused
+  size_t shard_size;
+  std::array<Shard, N> shards;
+
+  // hands out Affinity::THREAD slots, and Affinity::CPU ones where the
+  // CPU cannot be queried
+  static inline std::atomic<size_t> next_slot{0};
+};
+}  // namespace allocator
+
+#include "sharded_allocator.inl"
@@ -0,0 +1,216 @@
+#pragma once
+
+#include <sched.h>
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+#include "sharded_allocator.h"
+
+namespace allocator {
+template <typename Backend, size_t N, BufferType B, Affinity A>
+ShardedAllocator<Backend, N, B, A>::ShardedAllocator(size_t size)
+  requires(N > 0 && B == BufferType::HEAP &&
+           std::is_constructible_v<Backend, std::span<std::byte>>)
+    : buffer(static_cast<std::byte*>(::operator new(size))),
+      data(align_data(buffer)),
+      capacity(size - std::min<size_t>(data - buffer, size)),
+      shard_size(slice_size(capacity)),
+      shards(make_shards(std::make_index_sequence<N>{})) {}
+
+template <typename Backend, size_t N, BufferType B, Affinity A>
+ShardedAllocator<Backend, N, B, A>::ShardedAllocator(std::span<std::byte> buf)
+  requires(N > 0 && B == BufferType::EXTERNAL &&
+           std::is_constructible_v<Backend, std::span<std::byte>>)
+    : buffer(buf.data()),
+      data(align_data(buffer)),
+      capacity(buf.size() - std::min<size_t>(data - buffer, buf.size())),
+      shard_size(slice_size(capacity)),
+      shards(make_shards(std::make_index_sequence<N>{})) {}
+
+template <typename Backend, size_t N, BufferType B, Affinity A>
+ShardedAllocator<Backend, N, B, A>::ShardedAllocator(size_t size,
+                                                     MapOptions options)
+  requires(N > 0 && B == BufferType::MMAP &&
+           std::is_constructible_v<Backend, std::span<std::byte>>)
+    : buffer(map_buffer(size, options)),
+      data(buffer),
+      capacity(size),
+      shard_size(slice_size(capacity)),
+      shards(make_shards(std::make_index_sequence<N>{})) {}
+
+template <typename Backend, size_t N, BufferType B, Affinity A>
+ShardedAllocator<Backend, N, B, A>::~ShardedAllocator() noexcept {
+  // runs before the shards are destroyed, which is safe as backends over
+  // an external slice never touch it on destruction
+  if constexpr (B == BufferType::HEAP) {
+    ::operator delete(buffer);
+  } else if constexpr (B == BufferType::MMAP) {
+    unmap_buffer(buffer, capacity);
+  }
+}
+
+template <typename Backend, size_t N, BufferType B, Affinity A>
+std::byte* ShardedAllocator<Backend, N, B, A>::allocate(
+    size_t size, size_t alignment) noexcept {
+  // other shards are tried in turn, so a thread is only refused once the
+  // whole buffer is out of room rather than just its own slice
+  size_t home{get_home_shard()};
+  for (size_t i{}; i < N; ++i) {
+    Shard& shard{shards[(home + i) % N]};
+
+    std::lock_guard lock{shard.mutex};
+    if (std::byte* ptr{shard.backend.allocate(size, alignment)}) {
+      return ptr;
+    }
+  }
+
+  return nullptr;
+}
+
+template <typename Backend, size_t N, BufferType B, Affinity A>
+void ShardedAllocator<Backend, N, B, A>::deallocate(std::byte* ptr) noexcept {
+  if (!ptr) {
+    return;
+  }
+
+  // back to the owning shard, whichever thread or CPU frees it
+  Shard& shard{shards[get_shard(ptr)]};
+
+  std::lock_guard lock{shard.mutex};
+  shard.backend.deallocate(ptr);
+}
+
+template <typename Backend, size_t N, BufferType B, Affinity A>
+void ShardedAllocator<Backend, N, B, A>::reset() noexcept {
+  for (Shard& shard : shards) {
+    std::lock_guard lock{shard.mutex};
+    shard.backend.reset();
+  }
+}
+
+template <typename Backend, size_t N, BufferType B, Affinity A>
+size_t ShardedAllocator<Backend, N, B, A>::get_home_shard() const noexcept {
+  if constexpr (A == Affinity::CPU) {
+    // threads on one CPU run one at a time, so they rarely contend, and
+    // a thread that migrates simply follows its new CPU
+    int cpu{sched_getcpu()};
+    if (cpu >= 0) {
+      return static_cast<size_t>(cpu) % N;
+    }
+  }
+
+  // spreads threads round robin, in the order they first allocate
+  thread_local size_t slot{next_slot.fetch_add(1, std::memory_order_relaxed)};
+  return slot % N;
+}
+
+template <typename Backend, size_t N, BufferType B, Affinity A>
+size_t ShardedAllocator<Backend, N, B, A>::get_shard(
+    const std::byte* ptr) const noexcept {
+  assert(ptr >= data && ptr < data + N * shard_size &&
+         "pointer is not from this allocator");
+  return static_cast<size_t>(ptr - data) / shard_size;
+}
+
+template <typename Backend, size_t N, BufferType B, Affinity A>
+size_t ShardedAllocator<Backend, N, B, A>::get_used() const noexcept {
+  size_t used{};
+  for (const Shard& shard : shards) {
+    std::lock_guard lock{shard.mutex};
+    used += shard.backend.get_used();
+  }
+  return used;
+}
+
+template <typename Backend, size_t N, BufferType B, Affinity A>
+size_t ShardedAllocator<Backend, N, B, A>::get_free() const noexcept {
+  size_t free{};
+  for (const Shard& shard : shards) {
+    std::lock_guard lock{shard.mutex};
+    free += shard.backend.get_free();
+  }
+  return free;
+}
+
+//////////////////////
+// type-safe helpers
+//////////////////////
+
+template <typename Backend, size_t N, BufferType B, Affinity A>
+template <typename T>
+T* ShardedAllocator<Backend, N, B, A>::allocate(size_t count) noexcept {
+  if (count > SIZE_MAX / sizeof(T)) {  // check uint overflow
+    return nullptr;
+  }
+
+  size_t size{sizeof(T) * count};
+  size_t alignment{alignof(T)};
+  return reinterpret_cast<T*>(allocate(size, alignment));
+}
+
+template <typename Backend, size_t N, BufferType B, Affinity A>
+template <typename T>
+void ShardedAllocator<Backend, N, B, A>::deallocate(T* ptr) noexcept {
+  deallocate(reinterpret_cast<std::byte*>(ptr));
+}
+
+template <typename Backend, size_t N, BufferType B, Affinity A>
+template <typename T, typename... Args>
+T* ShardedAllocator<Backend, N, B, A>::emplace(Args&&... args) {
+  std::byte* ptr{allocate(sizeof(T), alignof(T))};
+  if (!ptr) {
+    return nullptr;
+  }
+
+  return std::construct_at(reinterpret_cast<T*>(ptr),
+                           std::forward<Args>(args)...);
+}
+
+template <typename Backend, size_t N, BufferType B, Affinity A>
+template <typename T>
+void ShardedAllocator<Backend, N, B, A>::destroy(T* ptr) noexcept {
+  // asymmetric, does not deallocate (only deallocate does)
+  if (ptr) {
+    std::destroy_at(ptr);
+  }
+}
+
+//////////////////////
+// helpers
+//////////////////////
+
+template <typename Backend, size_t N, BufferType B, Affinity A>
+size_t ShardedAllocator<Backend, N, B, A>::slice_size(
+    size_t capacity) noexcept {
+  size_t size{capacity / N - capacity / N % cache_line_size};
+
+  // a BuddyAllocator, the only backend with a base_alignment, would round
+  // its slice down to a power of 2 and leave the rest unused inside it.
+  // sized so up front, the slices stay contiguous and all of the loss, up
+  // to half the buffer, is in the tail
+  if constexpr (requires { Backend::base_alignment; }) {
+    size = std::bit_floor(size);
+  }
+  return size;
+}
+
+template <typename Backend, size_t N, BufferType B, Affinity A>
+template <size_t... I>
+std::array<typename ShardedAllocator<Backend, N, B, A>::Shard, N>
+ShardedAllocator<Backend, N, B, A>::make_shards(std::index_sequence<I...>) {
+  return {Shard{std::span<std::byte>{data + I * shard_size, shard_size}}...};
+}
+
+template <typename Backend, size_t N, BufferType B, Affinity A>
+std::byte* ShardedAllocator<Backend, N, B, A>::align_data(
+    std::byte* ptr) noexcept {
+  // slices start on cache lines, so this one has to as well
+  return reinterpret_cast<std::byte*>(
+      align_forward(reinterpret_cast<size_t>(ptr), cache_line_size));
+}
+}  // namespace allocator
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstddef>
+#include <type_traits>
+
+#include "common.h"
+
+namespace allocator {
+
+// std::allocator-style adapter over a caller-owned LinearAllocator,
+// FreeListAllocator or BuddyAllocator, for standard containers. copies
+// share the allocator, and follow the container on copy, move and swap.
+// deallocation is a no-op for allocators without one, as only reset()
+// reclaims their memory.
+template <typename T, typename Allocator>
+class StlAdapter {
+ public:
+  using value_type = T;
+  using size_type = size_t;
+  using difference_type = std::ptrdiff_t;
+
+  using propagate_on_container_copy_assignment = std::true_type;
+  using propagate_on_container_move_assignment = std::true_type;
+  using propagate_on_container_swap = std::true_type;
+  using is_always_equal = std::false_type;
+
+  template <typename U>
+  struct rebind {
+    using other = StlAdapter<U, Allocator>;
+  };
+
+  explicit StlAdapter(Allocator& allocator) noexcept;
+
+  template <typename U>
+  StlAdapter(const StlAdapter<U, Allocator>& other) noexcept;
+
+  [[nodiscard]] T* allocate(size_t count);
+  void deallocate(T* ptr, size_t count) noexcept;
+
+  Allocator& get_allocator() const noexcept;
+
+  template <typename U>
+  bool operator==(const StlAdapter<U, Allocator>& other) const noexcept;
+
+ private:
+  template <typename U, typename A>
+  friend class StlAdapter;
+
+  Allocator* allocator;
+};
+}  // namespace allocator
+
+#include "stl_adapter.inl"
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <new>
+
+#include "stl_adapter.h"
+
+namespace allocator {
+template <typename T, typename Allocator>
+StlAdapter<T, Allocator>::StlAdapter(Allocator& allocator) noexcept
+    : allocator(&allocator) {}
+
+template <typename T, typename Allocator>
+template <typename U>
+StlAdapter<T, Allocator>::StlAdapter(
+    const StlAdapter<U, Allocator>& other) noexcept
+    : allocator(other.allocator) {}
+
+template <typename T, typename Allocator>
+T* StlAdapter<T, Allocator>::allocate(size_t count) {
+  // containers expect a throw rather than nullptr
+  T* ptr{allocator->template allocate<T>(count)};
+  if (!ptr) {
+    throw std::bad_alloc{};
+  }
+
+  return ptr;
+}
+
+template <typename T, typename Allocator>
+void StlAdapter<T, Allocator>::deallocate(T* ptr, size_t count) noexcept {
+  // allocate<T>() asked for count objects of T, so the allocator can skip
+  // looking the size up
+  if constexpr (requires(std::byte* p) {
+                  allocator->deallocate(p, count, count);
+                }) {
+    allocator->deallocate(reinterpret_cast<std::byte*>(ptr),
+                          sizeof(T) * count, alignof(T));
+  } else if constexpr (requires { allocator->deallocate(ptr); }) {
+    allocator->deallocate(ptr);
+  }
+}
+
+template <typename T, typename Allocator>
+Allocator& StlAdapter<T, Allocator>::get_allocator() const noexcept {
+  return *allocator;
+}
+
+template <typename T, typename Allocator>
+template <typename U>
+bool StlAdapter<T, Allocator>::operator==(
+    const StlAdapter<U, Allocator>& other) const noexcept {
+  // adapters over the same allocator can free each other's memory
+  return allocator == other.allocator;
+}
+
+}  // namespace allocator
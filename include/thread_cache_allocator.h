@@ -0,0 +1,111 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <type_traits>
+
+#include "common.h"
+
+namespace allocator {
+
+// Backend is a FreeListAllocator or BuddyAllocator shared by all threads.
+// Requests up to MaxSize are served from per-thread magazines, one per
+// power-of-two size class, which exchange Batch blocks at a time with the
+// backend under its lock, through its bulk calls where it has them. Larger
+// requests go to the backend directly. Every block is aligned to
+// max_alignment at most, and typed requests for more fail.
+template <typename Backend, size_t MaxSize = 1024, size_t Batch = 32>
+class ThreadCacheAllocator {
+ public:
+  static constexpr size_t min_size{16};
+  static constexpr size_t max_alignment{alignof(std::max_align_t)};
+  static constexpr size_t class_count{
+      static_cast<size_t>(std::bit_width(MaxSize) - std::bit_width(min_size)) +
+      1};
+
+  template <typename... Args>
+  explicit ThreadCacheAllocator(Args&&... args)
+    requires(MaxSize >= min_size && (MaxSize & (MaxSize - 1)) == 0 &&
+             Batch > 0);
+  ~ThreadCacheAllocator() noexcept = default;
+
+  ThreadCacheAllocator(const ThreadCacheAllocator&) = delete;
+  ThreadCacheAllocator& operator=(const ThreadCacheAllocator&) = delete;
+
+  ThreadCacheAllocator(ThreadCacheAllocator&&) = delete;
+  ThreadCacheAllocator& operator=(ThreadCacheAllocator&&) = delete;
+
+  [[nodiscard]] std::byte* allocate(size_t size) noexcept;
+  void deallocate(std::byte* ptr, size_t size) noexcept;
+
+  // returns the calling thread's cached blocks to the backend
+  void flush() noexcept;
+
+  // includes blocks held in thread caches
+  size_t get_used() const noexcept;
+  size_t get_free() const noexcept;
+
+  //////////////////////
+  // type-safe helpers
+  //////////////////////
+  template <typename T>
+  [[nodiscard]] T* allocate(size_t count = 1) noexcept;
+
+  template <typename T>
+  void deallocate(T* ptr, size_t count = 1) noexcept;
+
+  template <typename T, typename... Args>
+  [[nodiscard]] T* emplace(Args&&... args);
+
+  template <typename T>
+  void destroy(T* ptr) noexcept;
+
+ private:
+  struct Shared {
+    template <typename... Args>
+    explicit Shared(Args&&... args) : backend(std::forward<Args>(args)...) {}
+
+    std::mutex mutex;
+    Backend backend;
+  };
+
+  struct Magazine {
+    std::array<std::byte*, 2 * Batch> blocks;
+    size_t count;
+  };
+
+  // lives in thread local storage and may outlive the allocator,
+  // so the backend is only reached through a weak reference
+  struct Cache {
+    std::weak_ptr<Shared> shared;
+    std::array<Magazine, class_count> magazines{};
+
+    ~Cache() noexcept;
+  };
+
+  Cache* local_cache() noexcept;
+
+  static size_t size_class(size_t size) noexcept;
+  // what the backend is asked for, so a class is served by any block size
+  static size_t block_alignment(size_t size) noexcept;
+  static std::byte* backend_allocate(Backend& backend, size_t size) noexcept;
+
+  static void refill(Shared& shared, Magazine& magazine,
+                     size_t index) noexcept;
+  static void drain(Shared& shared, Magazine& magazine, size_t count) noexcept;
+
+  std::shared_ptr<Shared> shared;
+
+  // distinguishes instances in the thread local registry, never reused
+  uint64_t id;
+  static inline std::atomic<uint64_t> next_id{1};
+};
+}  // namespace allocator
+
+#include "thread_cache_allocator.inl"
@@ -0,0 +1,258 @@
+#pragma once
+
+#include <algorithm>
+#include <memory>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "thread_cache_allocator.h"
+
+namespace allocator {
+template <typename Backend, size_t MaxSize, size_t Batch>
+template <typename... Args>
+ThreadCacheAllocator<Backend, MaxSize, Batch>::ThreadCacheAllocator(
+    Args&&... args)
+  requires(MaxSize >= min_size && (MaxSize & (MaxSize - 1)) == 0 && Batch > 0)
+    : shared(std::make_shared<Shared>(std::forward<Args>(args)...)),
+      id(next_id.fetch_add(1, std::memory_order_relaxed)) {}
+
+template <typename Backend, size_t MaxSize, size_t Batch>
+std::byte* ThreadCacheAllocator<Backend, MaxSize, Batch>::allocate(
+    size_t size) noexcept {
+  if (size > MaxSize) {
+    std::lock_guard lock{shared->mutex};
+    return backend_allocate(shared->backend, size);
+  }
+
+  Cache* cache{local_cache()};
+  if (!cache) {
+    return nullptr;
+  }
+
+  size_t index{size_class(size)};
+  Magazine& magazine{cache->magazines[index]};
+
+  if (magazine.count == 0) {
+    refill(*shared, magazine, index);
+    if (magazine.count == 0) {
+      return nullptr;
+    }
+  }
+
+  return magazine.blocks[--magazine.count];
+}
+
+template <typename Backend, size_t MaxSize, size_t Batch>
+void ThreadCacheAllocator<Backend, MaxSize, Batch>::deallocate(
+    std::byte* ptr, size_t size) noexcept {
+  if (!ptr) {
+    return;
+  }
+
+  Cache* cache{size <= MaxSize ? local_cache() : nullptr};
+  if (!cache) {
+    std::lock_guard lock{shared->mutex};
+    shared->backend.deallocate(ptr);
+    return;
+  }
+
+  Magazine& magazine{cache->magazines[size_class(size)]};
+  if (magazine.count == magazine.blocks.size()) {
+    // keeps Batch blocks cached so alternating calls don't thrash
+    drain(*shared, magazine, Batch);
+  }
+
+  magazine.blocks[magazine.count++] = ptr;
+}
+
+template <typename Backend, size_t MaxSize, size_t Batch>
+void ThreadCacheAllocator<Backend, MaxSize, Batch>::flush() noexcept {
+  Cache* cache{local_cache()};
+  if (!cache) {
+    return;
+  }
+
+  for (Magazine& magazine : cache->magazines) {
+    drain(*shared, magazine, magazine.count);
+  }
+}
+
+template <typename Backend, size_t MaxSize, size_t Batch>
+size_t ThreadCacheAllocator<Backend, MaxSize, Batch>::get_used()
+    const noexcept {
+  std::lock_guard lock{shared->mutex};
+  return shared->backend.get_used();
+}
+
+template <typename Backend, size_t MaxSize, size_t Batch>
+size_t ThreadCacheAllocator<Backend, MaxSize, Batch>::get_free()
+    const noexcept {
+  std::lock_guard lock{shared->mutex};
+  return shared->backend.get_free();
+}
+
+//////////////////////
+// type-safe helpers
+//////////////////////
+
+template <typename Backend, size_t MaxSize, size_t Batch>
+template <typename T>
+T* ThreadCacheAllocator<Backend, MaxSize, Batch>::allocate(
+    size_t count) noexcept {
+  if (count > SIZE_MAX / sizeof(T) || alignof(T) > max_alignment) {
+    return nullptr;
+  }
+
+  return reinterpret_cast<T*>(allocate(sizeof(T) * count));
+}
+
+template <typename Backend, size_t MaxSize, size_t Batch>
+template <typename T>
+void ThreadCacheAllocator<Backend, MaxSize, Batch>::deallocate(
+    T* ptr, size_t count) noexcept {
+  deallocate(reinterpret_cast<std::byte*>(ptr), sizeof(T) * count);
+}
+
+template <typename Backend, size_t MaxSize, size_t Batch>
+template <typename T, typename... Args>
+T* ThreadCacheAllocator<Backend, MaxSize, Batch>::emplace(Args&&... args) {
+  T* ptr{allocate<T>()};
+  if (!ptr) {
+    return nullptr;
+  }
+
+  return std::construct_at(ptr, std::forward<Args>(args)...);
+}
+
+template <typename Backend, size_t MaxSize, size_t Batch>
+template <typename T>
+void ThreadCacheAllocator<Backend, MaxSize, Batch>::destroy(T* ptr) noexcept {
+  // asymmetric, does not deallocate (only deallocate does)
+  if (ptr) {
+    std::destroy_at(ptr);
+  }
+}
+
+//////////////////////
+// helpers
+//////////////////////
+
+template <typename Backend, size_t MaxSize, size_t Batch>
+ThreadCacheAllocator<Backend, MaxSize, Batch>::Cache::~Cache() noexcept {
+  // thread exit, hand everything back if the allocator is still alive
+  if (std::shared_ptr<Shared> owner{shared.lock()}) {
+    for (Magazine& magazine : magazines) {
+      drain(*owner, magazine, magazine.count);
+    }
+  }
+}
+
+template <typename Backend, size_t MaxSize, size_t Batch>
+typename ThreadCacheAllocator<Backend, MaxSize, Batch>::Cache*
+ThreadCacheAllocator<Backend, MaxSize, Batch>::local_cache() noexcept {
+  // one slot remembers the last instance used, so the common case of a
+  // single allocator per thread never reaches the registry
+  thread_local uint64_t last_id{};
+  thread_local Cache* last_cache{};
+
+  if (last_id == id) {
+    return last_cache;
+  }
+
+  thread_local std::vector<std::pair<uint64_t, std::unique_ptr<Cache>>>
+      registry{};
+
+  auto found{std::ranges::find_if(
+      registry, [this](const auto& entry) { return entry.first == id; })};
+  if (found == registry.end()) {
+    try {
+      // drops caches of allocators that no longer exist
+      std::erase_if(registry, [](const auto& entry) {
+        return entry.second->shared.expired();
+      });
+
+      auto cache{std::make_unique<Cache>()};
+      cache->shared = shared;
+      registry.emplace_back(id, std::move(cache));
+      found = registry.end() - 1;
+    } catch (...) {
+      return nullptr;
+    }
+  }
+
+  last_id = id;
+  last_cache = found->second.get();
+  return last_cache;
+}
+
+template <typename Backend, size_t MaxSize, size_t Batch>
+size_t ThreadCacheAllocator<Backend, MaxSize, Batch>::size_class(
+    size_t size) noexcept {
+  size_t effective_size{std::bit_ceil(std::max(size, min_size))};
+  return static_cast<size_t>(std::bit_width(effective_size) -
+                             std::bit_width(min_size));
+}
+
+template <typename Backend, size_t MaxSize, size_t Batch>
+size_t ThreadCacheAllocator<Backend, MaxSize, Batch>::block_alignment(
+    size_t size) noexcept {
+  return std::min(std::bit_ceil(std::max(size, min_size)), max_alignment);
+}
+
+template <typename Backend, size_t MaxSize, size_t Batch>
+std::byte* ThreadCacheAllocator<Backend, MaxSize, Batch>::backend_allocate(
+    Backend& backend, size_t size) noexcept {
+  if constexpr (requires { backend.allocate(size, size); }) {
+    return backend.allocate(size, block_alignment(size));
+  } else {
+    return backend.allocate(size);
+  }
+}
+
+template <typename Backend, size_t MaxSize, size_t Batch>
+void ThreadCacheAllocator<Backend, MaxSize, Batch>::refill(
+    Shared& shared, Magazine& magazine, size_t index) noexcept {
+  size_t size{min_size << index};
+  std::span<std::byte*> out{std::span{magazine.blocks}.subspan(
+      magazine.count, Batch - magazine.count)};
+
+  std::lock_guard lock{shared.mutex};
+  if constexpr (requires { shared.backend.allocate_bulk(0, 0, 1, out); }) {
+    // one search of the backend's free blocks for the whole batch
+    magazine.count += shared.backend.allocate_bulk(
+        out.size(), size, block_alignment(size), out);
+  } else {
+    while (magazine.count < Batch) {
+      std::byte* block{backend_allocate(shared.backend, size)};
+      if (!block) {
+        break;
+      }
+      magazine.blocks[magazine.count++] = block;
+    }
+  }
+}
+
+template <typename Backend, size_t MaxSize, size_t Batch>
+void ThreadCacheAllocator<Backend, MaxSize, Batch>::drain(
+    Shared& shared, Magazine& magazine, size_t count) noexcept {
+  if (count == 0) {
+    return;
+  }
+
+  // oldest blocks leave first, the most recently freed stay hot
+  std::span<std::byte*> oldest{std::span{magazine.blocks}.first(count)};
+  std::lock_guard lock{shared.mutex};
+  if constexpr (requires { shared.backend.deallocate_bulk(oldest); }) {
+    shared.backend.deallocate_bulk(oldest);
+  } else {
+    for (std::byte* block : oldest) {
+      shared.backend.deallocate(block);
+    }
+  }
+
+  std::copy(magazine.blocks.begin() + count,
+            magazine.blocks.begin() + magazine.count, magazine.blocks.begin());
+  magazine.count -= count;
+}
+}  // namespace allocator
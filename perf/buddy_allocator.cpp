@@ -2,10 +2,124 @@
 
 #include <benchmark/benchmark.h>
 
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+
 #include "benchmark_setup.h"
 
 namespace allocator::perf {
+// bursts of large blocks that are written once and then all freed
+inline constexpr size_t BURST_CAPACITY{size_t{1} << 24};
+inline constexpr size_t BURST_BLOCK{size_t{1} << 18};
+
+// threads allocating and freeing a batch of mixed sizes from one arena
+inline constexpr size_t SCALING_BATCH{16};
+inline constexpr size_t SCALING_SIZES[]{32, 64, 256, 1024};
+
+using BuddyConcurrent = BuddyAllocator<BURST_CAPACITY, BufferType::HEAP,
+                                       Tracking::NONE, Decommit::NONE,
+                                       Concurrency::PER_LEVEL>;
+
+static void BM_Scaling_Buddy(::benchmark::State& state) {
+  static BuddyConcurrent alloc{};
+  std::byte* pointers[SCALING_BATCH]{};
+
+  for (auto _ : state) {
+    for (size_t i{}; i < SCALING_BATCH; ++i) {
+      pointers[i] = alloc.allocate(SCALING_SIZES[i % 4]);
+      ::benchmark::DoNotOptimize(pointers[i]);
+    }
+    for (auto* ptr : pointers) {
+      alloc.deallocate(ptr);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * SCALING_BATCH);
+}
+
+// the same workload on a sequential BuddyAllocator behind one lock
+static void BM_Scaling_BuddyLocked(::benchmark::State& state) {
+  static BuddyAllocator<BURST_CAPACITY> alloc{};
+  static std::mutex mutex{};
+  std::byte* pointers[SCALING_BATCH]{};
+
+  for (auto _ : state) {
+    for (size_t i{}; i < SCALING_BATCH; ++i) {
+      std::lock_guard lock{mutex};
+      pointers[i] = alloc.allocate(SCALING_SIZES[i % 4]);
+      ::benchmark::DoNotOptimize(pointers[i]);
+    }
+    for (auto* ptr : pointers) {
+      std::lock_guard lock{mutex};
+      alloc.deallocate(ptr);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * SCALING_BATCH);
+}
+
+static void BM_Scaling_Malloc(::benchmark::State& state) {
+  void* pointers[SCALING_BATCH]{};
+
+  for (auto _ : state) {
+    for (size_t i{}; i < SCALING_BATCH; ++i) {
+      pointers[i] = std::malloc(SCALING_SIZES[i % 4]);
+      ::benchmark::DoNotOptimize(pointers[i]);
+    }
+    for (auto* ptr : pointers) {
+      std::free(ptr);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * SCALING_BATCH);
+}
+
+template <typename Allocator>
+inline void BM_Burst(::benchmark::State& state) {
+  auto alloc{std::make_unique<Allocator>()};
+  std::byte* pointers[BURST_CAPACITY / BURST_BLOCK]{};
+
+  for (auto _ : state) {
+    for (auto& ptr : pointers) {
+      ptr = alloc->allocate(BURST_BLOCK);
+      for (size_t offset{}; offset < BURST_BLOCK; offset += page_size) {
+        ptr[offset] = std::byte{1};
+      }
+    }
+    for (auto* ptr : pointers) {
+      alloc->deallocate(ptr);
+    }
+  }
+  state.SetBytesProcessed(state.iterations() * BURST_CAPACITY);
+}
+
 using BuddyAllocatorHeap = BuddyAllocator<CAPACITY>;
+
+// a block doubled from 64 bytes to half the arena, in place by taking its
+// buddies, or by allocating, copying and freeing at every step. the copy
+// needs room for both blocks, so it cannot go further
+template <bool InPlace>
+inline void BM_Grow(::benchmark::State& state) {
+  auto alloc{std::make_unique<BuddyAllocatorHeap>()};
+  size_t steps{};
+
+  for (auto _ : state) {
+    std::byte* ptr{alloc->allocate(64)};
+    for (size_t size{128}; size <= CAPACITY / 2; size *= 2) {
+      if constexpr (InPlace) {
+        ptr = alloc->reallocate(ptr, size, 1);
+      } else {
+        std::byte* grown{alloc->allocate(size)};
+        std::memcpy(grown, ptr, size / 2);
+        alloc->deallocate(ptr);
+        ptr = grown;
+      }
+      ::benchmark::DoNotOptimize(ptr);
+      ++steps;
+    }
+    alloc->deallocate(ptr);
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(steps));
+}
+
 using BuddyAllocatorStack = BuddyAllocator<CAPACITY, BufferType::STACK>;
 using BuddyAllocatorExternal = BuddyAllocator<CAPACITY, BufferType::EXTERNAL>;
 
@@ -33,4 +147,52 @@ BENCHMARK(BM_Workload<BuddyAllocatorHeap>)->Name("BM_Workload/Buddy/Heap");
 BENCHMARK(BM_Workload<BuddyAllocatorStack>)->Name("BM_Workload/Buddy/Stack");
 BENCHMARK(BM_Workload<BuddyAllocatorExternal>)->Name("BM_Workload/Buddy/External");
 
+//////////////////////////////
+// churn benchmarks
+//////////////////////////////
+
+BENCHMARK(BM_Churn<BuddyAllocatorHeap>)->Name("BM_Churn/Buddy/Heap");
+
+//////////////////////////////
+// bulk benchmarks
+//////////////////////////////
+
+BENCHMARK(BM_Batch<BuddyAllocatorHeap>)->Name("BM_Batch/Buddy/Heap");
+BENCHMARK(BM_Bulk<BuddyAllocatorHeap>)->Name("BM_Bulk/Buddy/Heap");
+BENCHMARK(BM_Sized<BuddyAllocatorHeap>)->Name("BM_Sized/Buddy/Heap");
+
+//////////////////////////////
+// grow benchmarks
+//////////////////////////////
+
+BENCHMARK(BM_Grow<true>)->Name("BM_Grow/Buddy/Heap/Reallocate");
+BENCHMARK(BM_Grow<false>)->Name("BM_Grow/Buddy/Heap/Copy");
+
+//////////////////////////////
+// burst benchmarks
+//////////////////////////////
+
+BENCHMARK(BM_Burst<BuddyAllocator<BURST_CAPACITY>>)
+    ->Name("BM_Burst/Buddy/Retained");
+BENCHMARK(BM_Burst<BuddyAllocator<BURST_CAPACITY, BufferType::HEAP,
+                                  Tracking::NONE, Decommit::INLINE>>)
+    ->Name("BM_Burst/Buddy/Decommitted");
+
+//////////////////////////////
+// scaling benchmarks
+//////////////////////////////
+
+BENCHMARK(BM_Scaling_Buddy)
+    ->Name("BM_Scaling/Buddy/PerLevel")
+    ->ThreadRange(1, 8)
+    ->UseRealTime();
+BENCHMARK(BM_Scaling_BuddyLocked)
+    ->Name("BM_Scaling/Buddy/Mutex")
+    ->ThreadRange(1, 8)
+    ->UseRealTime();
+BENCHMARK(BM_Scaling_Malloc)
+    ->Name("BM_Scaling/Malloc")
+    ->ThreadRange(1, 8)
+    ->UseRealTime();
+
 }  // namespace allocator::perf
\ No newline at end of file
@@ -0,0 +1,59 @@
+#include "concurrent_linear_allocator.h"
+
+#include <benchmark/benchmark.h>
+
+#include <mutex>
+
+#include "benchmark_setup.h"
+#include "linear_allocator.h"
+
+namespace allocator::perf {
+// threads share one arena, and whichever finds it full resets it. the
+// memory is never written, so racing a reset is harmless here
+static void BM_SharedArena_Concurrent(::benchmark::State& state) {
+  static ConcurrentLinearAllocator<CAPACITY> alloc{};
+
+  for (auto _ : state) {
+    for (int i{}; i < ROUNDS; ++i) {
+      std::byte* ptr{alloc.allocate(64, 8)};
+      if (!ptr) {
+        alloc.reset();
+      }
+      ::benchmark::DoNotOptimize(ptr);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * ROUNDS);
+}
+
+// the same workload on a LinearAllocator behind a lock
+static void BM_SharedArena_Locked(::benchmark::State& state) {
+  static LinearAllocator<CAPACITY> alloc{};
+  static std::mutex mutex{};
+
+  for (auto _ : state) {
+    for (int i{}; i < ROUNDS; ++i) {
+      std::lock_guard lock{mutex};
+      std::byte* ptr{alloc.allocate(64, 8)};
+      if (!ptr) {
+        alloc.reset();
+      }
+      ::benchmark::DoNotOptimize(ptr);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * ROUNDS);
+}
+
+//////////////////////////////
+// shared arena benchmarks
+//////////////////////////////
+
+BENCHMARK(BM_SharedArena_Concurrent)
+    ->Name("BM_SharedArena/ConcurrentLinear")
+    ->ThreadRange(1, 8)
+    ->UseRealTime();
+BENCHMARK(BM_SharedArena_Locked)
+    ->Name("BM_SharedArena/Linear/Mutex")
+    ->ThreadRange(1, 8)
+    ->UseRealTime();
+
+}  // namespace allocator::perf
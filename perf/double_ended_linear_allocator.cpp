@@ -0,0 +1,69 @@
+#include "double_ended_linear_allocator.h"
+
+#include <benchmark/benchmark.h>
+
+#include "benchmark_setup.h"
+#include "linear_allocator.h"
+
+namespace allocator::perf {
+using DoubleEndedHeap = DoubleEndedLinearAllocator<CAPACITY>;
+using DoubleEndedStack =
+    DoubleEndedLinearAllocator<CAPACITY, BufferType::STACK>;
+using LinearHeap = LinearAllocator<CAPACITY / 2>;
+
+// frames of short-lived objects, with a longer-lived object kept per frame
+// until the level is reset every LEVEL frames
+inline constexpr int LEVEL{64};
+
+template <typename Allocator>
+inline void BM_Frames(::benchmark::State& state) {
+  Setup<Allocator> setup{};
+  int frame{};
+
+  for (auto _ : state) {
+    for (int i{}; i < ROUNDS; ++i) {
+      Obj* obj{setup.alloc->template emplace_front<Obj>(i, i * 1.5)};
+      ::benchmark::DoNotOptimize(obj);
+    }
+    Obj* persistent{setup.alloc->template emplace_back<Obj>(frame, 0.5)};
+    ::benchmark::DoNotOptimize(persistent);
+
+    setup.alloc->reset_front();
+    if (++frame % LEVEL == 0) {
+      setup.alloc->reset_back();
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * (ROUNDS + 1));
+}
+
+// the same workload split over two arenas of half the capacity each
+static void BM_Frames_TwoLinear(::benchmark::State& state) {
+  LinearHeap frames{};
+  LinearHeap level{};
+  int frame{};
+
+  for (auto _ : state) {
+    for (int i{}; i < ROUNDS; ++i) {
+      Obj* obj{frames.emplace<Obj>(i, i * 1.5)};
+      ::benchmark::DoNotOptimize(obj);
+    }
+    Obj* persistent{level.emplace<Obj>(frame, 0.5)};
+    ::benchmark::DoNotOptimize(persistent);
+
+    frames.reset();
+    if (++frame % LEVEL == 0) {
+      level.reset();
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * (ROUNDS + 1));
+}
+
+//////////////////////////////
+// frame benchmarks
+//////////////////////////////
+
+BENCHMARK(BM_Frames<DoubleEndedHeap>)->Name("BM_Frames/DoubleEnded/Heap");
+BENCHMARK(BM_Frames<DoubleEndedStack>)->Name("BM_Frames/DoubleEnded/Stack");
+BENCHMARK(BM_Frames_TwoLinear)->Name("BM_Frames/Linear/TwoArenas");
+
+}  // namespace allocator::perf
@@ -0,0 +1,72 @@
+#include "frame_allocator.h"
+
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <cstring>
+
+#include "benchmark_setup.h"
+#include "linear_allocator.h"
+
+namespace allocator::perf {
+using LinearHeap = LinearAllocator<CAPACITY>;
+using DoubleBuffered = FrameAllocator<LinearHeap, 2>;
+
+// bytes a frame hands to the consumers running in the frame after it
+inline constexpr size_t PAYLOAD{CAPACITY / 4};
+
+inline void produce(std::byte* data) {
+  std::memset(data, 1, PAYLOAD);
+  ::benchmark::DoNotOptimize(data);
+}
+
+inline void consume(const std::byte* data) {
+  ::benchmark::DoNotOptimize(data[PAYLOAD - 1]);
+}
+
+static void BM_Handoff_DoubleBuffered(::benchmark::State& state) {
+  DoubleBuffered frames{};
+  const std::byte* previous{};
+
+  for (auto _ : state) {
+    std::byte* data{frames.allocate(PAYLOAD, 64)};
+    produce(data);
+    if (previous) {
+      consume(previous);
+    }
+
+    // last frame's data stays valid through this one
+    previous = data;
+    frames.next_frame();
+  }
+  state.SetBytesProcessed(state.iterations() * PAYLOAD);
+}
+
+// copies the payload out of a single arena before each reset
+static void BM_Handoff_CopyOut(::benchmark::State& state) {
+  LinearHeap arena{};
+  alignas(64) static std::array<std::byte, PAYLOAD> copy{};
+  bool has_previous{};
+
+  for (auto _ : state) {
+    std::byte* data{arena.allocate(PAYLOAD, 64)};
+    produce(data);
+    if (has_previous) {
+      consume(copy.data());
+    }
+
+    std::memcpy(copy.data(), data, PAYLOAD);
+    has_previous = true;
+    arena.reset();
+  }
+  state.SetBytesProcessed(state.iterations() * PAYLOAD);
+}
+
+//////////////////////////////
+// handoff benchmarks
+//////////////////////////////
+
+BENCHMARK(BM_Handoff_DoubleBuffered)->Name("BM_Handoff/Frame/DoubleBuffered");
+BENCHMARK(BM_Handoff_CopyOut)->Name("BM_Handoff/Linear/CopyOut");
+
+}  // namespace allocator::perf
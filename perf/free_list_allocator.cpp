@@ -2,6 +2,9 @@
 
 #include <benchmark/benchmark.h>
 
+#include <cstring>
+#include <vector>
+
 #include "benchmark_setup.h"
 
 namespace allocator::perf {
@@ -15,6 +18,86 @@ using FreeListExternalFirst = FreeListAllocator<CAPACITY, BufferType::EXTERNAL>;
 using FreeListExternalBest =
     FreeListAllocator<CAPACITY, BufferType::EXTERNAL, FitStrategy::BEST>;
 
+// large enough for 2 * 16384 blocks of 64 bytes and their headers
+using FreeListLargeFirst = FreeListAllocator<size_t{1} << 22>;
+using FreeListLargeBest =
+    FreeListAllocator<size_t{1} << 22, BufferType::HEAP, FitStrategy::BEST>;
+
+// frees a block between two free fragments, with range(0) fragments on the
+// free list. coalescing reads the boundary tags, so latency should not grow
+// with the length of the list
+inline void BM_FreeLatency(::benchmark::State& state) {
+  auto alloc{std::make_unique<FreeListLargeFirst>()};
+  size_t fragments{static_cast<size_t>(state.range(0))};
+
+  std::vector<std::byte*> blocks(2 * fragments + 1);
+  for (auto& block : blocks) {
+    block = alloc->allocate(64, 8);
+  }
+  for (size_t i{}; i < blocks.size(); i += 2) {
+    alloc->deallocate(blocks[i]);
+  }
+
+  std::byte* ptr{blocks[fragments | 1]};
+  for (auto _ : state) {
+    alloc->deallocate(ptr);
+    ptr = alloc->allocate(64, 8);
+    ::benchmark::DoNotOptimize(ptr);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+// allocates past range(0) free fragments that are all too small, so only
+// the block at the end of the buffer fits
+template <typename Allocator>
+inline void BM_Fragmented(::benchmark::State& state) {
+  auto alloc{std::make_unique<Allocator>()};
+  size_t fragments{static_cast<size_t>(state.range(0))};
+
+  std::vector<std::byte*> blocks(2 * fragments);
+  for (auto& block : blocks) {
+    block = alloc->allocate(64, 8);
+  }
+  for (size_t i{}; i < blocks.size(); i += 2) {
+    alloc->deallocate(blocks[i]);
+  }
+
+  for (auto _ : state) {
+    std::byte* ptr{alloc->allocate(128, 8)};
+    ::benchmark::DoNotOptimize(ptr);
+    alloc->deallocate(ptr);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+// doubles one buffer from 64 bytes to a quarter of the capacity, as a
+// growable byte buffer would, either with reallocate() or by allocating,
+// copying and freeing at every step. the copy needs room for both blocks
+// past the ones freed before, so it cannot go further
+template <bool InPlace>
+inline void BM_Grow(::benchmark::State& state) {
+  auto alloc{std::make_unique<FreeListHeapFirst>()};
+  size_t steps{};
+
+  for (auto _ : state) {
+    std::byte* ptr{alloc->allocate(64, 8)};
+    for (size_t size{128}; size <= CAPACITY / 4; size *= 2) {
+      if constexpr (InPlace) {
+        ptr = alloc->reallocate(ptr, size, 8);
+      } else {
+        std::byte* grown{alloc->allocate(size, 8)};
+        std::memcpy(grown, ptr, size / 2);
+        alloc->deallocate(ptr);
+        ptr = grown;
+      }
+      ::benchmark::DoNotOptimize(ptr);
+      ++steps;
+    }
+    alloc->deallocate(ptr);
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(steps));
+}
+
 //////////////////////////////
 // allocation benchmarks
 //////////////////////////////
@@ -55,4 +138,42 @@ BENCHMARK(BM_Workload<FreeListStackBest>)->Name("BM_Workload/FreeList/Stack/Best
 BENCHMARK(BM_Workload<FreeListExternalFirst>)->Name("BM_Workload/FreeList/External/FirstFit");
 BENCHMARK(BM_Workload<FreeListExternalBest>)->Name("BM_Workload/FreeList/External/BestFit");
 
+//////////////////////////////
+// churn benchmarks
+//////////////////////////////
+
+BENCHMARK(BM_Churn<FreeListHeapFirst>)->Name("BM_Churn/FreeList/Heap/FirstFit");
+BENCHMARK(BM_Churn<FreeListHeapBest>)->Name("BM_Churn/FreeList/Heap/BestFit");
+
+//////////////////////////////
+// bulk benchmarks
+//////////////////////////////
+
+BENCHMARK(BM_Batch<FreeListHeapFirst>)->Name("BM_Batch/FreeList/Heap/FirstFit");
+BENCHMARK(BM_Batch<FreeListHeapBest>)->Name("BM_Batch/FreeList/Heap/BestFit");
+BENCHMARK(BM_Bulk<FreeListHeapFirst>)->Name("BM_Bulk/FreeList/Heap/FirstFit");
+BENCHMARK(BM_Bulk<FreeListHeapBest>)->Name("BM_Bulk/FreeList/Heap/BestFit");
+BENCHMARK(BM_Sized<FreeListHeapFirst>)->Name("BM_Sized/FreeList/Heap/FirstFit");
+BENCHMARK(BM_Sized<FreeListHeapBest>)->Name("BM_Sized/FreeList/Heap/BestFit");
+
+//////////////////////////////
+// grow benchmarks
+//////////////////////////////
+
+BENCHMARK(BM_Grow<true>)->Name("BM_Grow/FreeList/Heap/Reallocate");
+BENCHMARK(BM_Grow<false>)->Name("BM_Grow/FreeList/Heap/Copy");
+
+//////////////////////////////
+// free latency benchmarks
+//////////////////////////////
+
+BENCHMARK(BM_FreeLatency)->Name("BM_FreeLatency/FreeList/Heap/FirstFit")->RangeMultiplier(4)->Range(64, 16384);
+
+//////////////////////////////
+// fragmented benchmarks
+//////////////////////////////
+
+BENCHMARK(BM_Fragmented<FreeListLargeFirst>)->Name("BM_Fragmented/FreeList/Heap/FirstFit")->RangeMultiplier(4)->Range(64, 16384);
+BENCHMARK(BM_Fragmented<FreeListLargeBest>)->Name("BM_Fragmented/FreeList/Heap/BestFit")->RangeMultiplier(4)->Range(64, 16384);
+
 }  // namespace allocator::perf
\ No newline at end of file
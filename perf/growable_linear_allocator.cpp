@@ -0,0 +1,52 @@
+#include "growable_linear_allocator.h"
+
+#include <benchmark/benchmark.h>
+
+#include "benchmark_setup.h"
+#include "linear_allocator.h"
+
+namespace allocator::perf {
+using LinearHeap = LinearAllocator<CAPACITY>;
+using GrowableLargest = GrowableLinearAllocator<>;
+using GrowableHighWater =
+    GrowableLinearAllocator<HeapUpstream, Retention::HIGH_WATER>;
+
+// a request's worth of allocations, with one large outlier per request
+template <typename Allocator>
+inline void fill_request(Allocator& alloc) {
+  for (int i{}; i < ROUNDS; ++i) {
+    Obj* obj{alloc.template emplace<Obj>(i, i * 1.5)};
+    ::benchmark::DoNotOptimize(obj);
+  }
+  ::benchmark::DoNotOptimize(alloc.allocate(8192, 16));
+  alloc.reset();
+}
+
+template <typename Allocator>
+inline void BM_Request(::benchmark::State& state) {
+  // starts small, where a fixed arena is sized for the worst case
+  Allocator alloc{1024};
+  for (auto _ : state) {
+    fill_request(alloc);
+  }
+  state.SetItemsProcessed(state.iterations() * ROUNDS);
+}
+
+static void BM_Request_Fixed(::benchmark::State& state) {
+  LinearHeap alloc{};
+  for (auto _ : state) {
+    fill_request(alloc);
+  }
+  state.SetItemsProcessed(state.iterations() * ROUNDS);
+}
+
+//////////////////////////////
+// request benchmarks
+//////////////////////////////
+
+BENCHMARK(BM_Request_Fixed)->Name("BM_Request/Linear/Heap");
+BENCHMARK(BM_Request<GrowableLargest>)->Name("BM_Request/Growable/Largest");
+BENCHMARK(BM_Request<GrowableHighWater>)
+    ->Name("BM_Request/Growable/HighWater");
+
+}  // namespace allocator::perf
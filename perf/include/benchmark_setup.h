@@ -20,7 +20,7 @@ struct Obj {
 template <typename Allocator>
 struct Setup {
   std::unique_ptr<Allocator> alloc{};
-  std::array<std::byte, CAPACITY> buf{};
+  alignas(std::max_align_t) std::array<std::byte, CAPACITY> buf{};
 
   Setup() {
     if constexpr (Allocator::buffer_type == BufferType::EXTERNAL) {
@@ -39,8 +39,10 @@ inline void BM_Allocation(::benchmark::State& state) {
 
     if constexpr (requires { setup.alloc->allocate(64, 8); }) {
       ptr = setup.alloc->allocate(64, 8);
-    } else {
+    } else if constexpr (requires { setup.alloc->allocate(64); }) {
       ptr = setup.alloc->allocate(64);
+    } else {
+      ptr = setup.alloc->allocate();
     }
 
     ::benchmark::DoNotOptimize(ptr);
@@ -83,4 +85,86 @@ inline void BM_Workload(::benchmark::State& state) {
   state.SetItemsProcessed(state.iterations() * ROUNDS);
 }
 
+// individual deallocation instead of reset, for allocators that support it
+template <typename Allocator>
+inline void BM_Churn(::benchmark::State& state) {
+  Setup<Allocator> setup{};
+  Obj* objects[ROUNDS];
+
+  for (auto _ : state) {
+    for (int i{}; i < ROUNDS; ++i) {
+      objects[i] = setup.alloc->template emplace<Obj>(i, i * 1.5);
+      ::benchmark::DoNotOptimize(objects[i]);
+    }
+
+    for (int i{}; i < ROUNDS; ++i) {
+      setup.alloc->template destroy<Obj>(objects[i]);
+      setup.alloc->template deallocate<Obj>(objects[i]);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * ROUNDS);
+}
+
+// ROUNDS blocks of one size, one call each, the baseline for BM_Bulk
+template <typename Allocator>
+inline void BM_Batch(::benchmark::State& state) {
+  Setup<Allocator> setup{};
+  std::byte* blocks[ROUNDS];
+
+  for (auto _ : state) {
+    for (int i{}; i < ROUNDS; ++i) {
+      blocks[i] = setup.alloc->allocate(64, 8);
+    }
+    ::benchmark::DoNotOptimize(blocks);
+
+    if constexpr (requires { setup.alloc->deallocate(blocks[0]); }) {
+      for (std::byte* block : blocks) {
+        setup.alloc->deallocate(block);
+      }
+    } else {
+      setup.alloc->reset();
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * ROUNDS);
+}
+
+// the same blocks freed with the size and alignment they were allocated with
+template <typename Allocator>
+inline void BM_Sized(::benchmark::State& state) {
+  Setup<Allocator> setup{};
+  std::byte* blocks[ROUNDS];
+
+  for (auto _ : state) {
+    for (int i{}; i < ROUNDS; ++i) {
+      blocks[i] = setup.alloc->allocate(64, 8);
+    }
+    ::benchmark::DoNotOptimize(blocks);
+
+    for (std::byte* block : blocks) {
+      setup.alloc->deallocate(block, 64, 8);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * ROUNDS);
+}
+
+// the same blocks from a single allocate_bulk() call
+template <typename Allocator>
+inline void BM_Bulk(::benchmark::State& state) {
+  Setup<Allocator> setup{};
+  std::byte* blocks[ROUNDS];
+
+  for (auto _ : state) {
+    size_t count{setup.alloc->allocate_bulk(ROUNDS, 64, 8, blocks)};
+    ::benchmark::DoNotOptimize(count);
+    ::benchmark::DoNotOptimize(blocks);
+
+    if constexpr (requires { setup.alloc->deallocate_bulk(blocks); }) {
+      setup.alloc->deallocate_bulk(blocks);
+    } else {
+      setup.alloc->reset();
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * ROUNDS);
+}
+
 }  // namespace allocator::perf
\ No newline at end of file
@@ -33,4 +33,11 @@ BENCHMARK(BM_Workload<LinearHeap>)->Name("BM_Workload/Linear/Heap");
 BENCHMARK(BM_Workload<LinearStack>)->Name("BM_Workload/Linear/Stack");
 BENCHMARK(BM_Workload<LinearExternal>)->Name("BM_Workload/Linear/External");
 
+//////////////////////////////
+// bulk benchmarks
+//////////////////////////////
+
+BENCHMARK(BM_Batch<LinearHeap>)->Name("BM_Batch/Linear/Heap");
+BENCHMARK(BM_Bulk<LinearHeap>)->Name("BM_Bulk/Linear/Heap");
+
 }  // namespace allocator::perf
\ No newline at end of file
@@ -0,0 +1,74 @@
+#include "memory_resource.h"
+
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <memory_resource>
+#include <unordered_map>
+
+#include "benchmark_setup.h"
+#include "buddy_allocator.h"
+#include "free_list_allocator.h"
+#include "linear_allocator.h"
+
+namespace allocator::perf {
+using LinearHeap = LinearAllocator<CAPACITY>;
+using FreeListHeap = FreeListAllocator<CAPACITY>;
+using BuddyHeap = BuddyAllocator<CAPACITY>;
+
+// fills and tears down a node-based pmr container on the given resource
+inline void fill_map(std::pmr::memory_resource* resource) {
+  std::pmr::unordered_map<int, int> map{resource};
+  for (int i{}; i < ROUNDS; ++i) {
+    map.emplace(i, i);
+  }
+  ::benchmark::DoNotOptimize(map.size());
+}
+
+template <typename Allocator>
+inline void BM_PmrMap(::benchmark::State& state) {
+  Setup<Allocator> setup{};
+  MemoryResource<Allocator> resource{*setup.alloc};
+
+  for (auto _ : state) {
+    fill_map(&resource);
+
+    // only reset() reclaims memory from allocators without deallocate()
+    if constexpr (!requires(std::byte* p) { setup.alloc->deallocate(p); }) {
+      setup.alloc->reset();
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * ROUNDS);
+}
+
+static void BM_PmrMap_NewDelete(::benchmark::State& state) {
+  for (auto _ : state) {
+    fill_map(std::pmr::new_delete_resource());
+  }
+  state.SetItemsProcessed(state.iterations() * ROUNDS);
+}
+
+static void BM_PmrMap_Monotonic(::benchmark::State& state) {
+  alignas(std::max_align_t) static std::array<std::byte, CAPACITY> buf{};
+  std::pmr::monotonic_buffer_resource resource{
+      buf.data(), buf.size(), std::pmr::null_memory_resource()};
+
+  for (auto _ : state) {
+    fill_map(&resource);
+    resource.release();
+  }
+  state.SetItemsProcessed(state.iterations() * ROUNDS);
+}
+
+//////////////////////////////
+// pmr benchmarks
+//////////////////////////////
+
+BENCHMARK(BM_PmrMap<LinearHeap>)->Name("BM_PmrMap/Linear/Heap");
+BENCHMARK(BM_PmrMap<FreeListHeap>)->Name("BM_PmrMap/FreeList/Heap/FirstFit");
+BENCHMARK(BM_PmrMap<BuddyHeap>)->Name("BM_PmrMap/Buddy/Heap");
+
+BENCHMARK(BM_PmrMap_NewDelete)->Name("BM_PmrMap/STL/NewDelete");
+BENCHMARK(BM_PmrMap_Monotonic)->Name("BM_PmrMap/STL/Monotonic");
+
+}  // namespace allocator::perf
@@ -0,0 +1,50 @@
+#include "mmap_buffer.h"
+
+#include <benchmark/benchmark.h>
+
+#include <memory>
+
+#include "benchmark_setup.h"
+#include "linear_allocator.h"
+
+namespace allocator::perf {
+// large enough that page faults dominate the cost of filling the arena
+inline constexpr size_t ARENA{64 * 1024 * 1024};
+
+using LinearHeap = LinearAllocator<ARENA>;
+using LinearMapped = LinearAllocator<ARENA, BufferType::MMAP>;
+
+// a fresh arena per iteration, written once per page as a first touch
+template <typename Allocator, MapOptions Options = MapOptions{}>
+inline void BM_FirstTouch(::benchmark::State& state) {
+  for (auto _ : state) {
+    std::unique_ptr<Allocator> alloc{};
+    if constexpr (Allocator::buffer_type == BufferType::MMAP) {
+      alloc = std::make_unique<Allocator>(Options);
+    } else {
+      alloc = std::make_unique<Allocator>();
+    }
+
+    std::byte* ptr{alloc->allocate(ARENA, 8)};
+    for (size_t offset{}; offset < ARENA; offset += page_size) {
+      ptr[offset] = std::byte{1};
+    }
+    ::benchmark::DoNotOptimize(ptr);
+  }
+  state.SetBytesProcessed(state.iterations() * ARENA);
+}
+
+//////////////////////////////
+// first touch benchmarks
+//////////////////////////////
+
+BENCHMARK(BM_FirstTouch<LinearHeap>)->Name("BM_FirstTouch/Linear/Heap");
+BENCHMARK(BM_FirstTouch<LinearMapped, MapOptions{HugePages::NONE, false}>)
+    ->Name("BM_FirstTouch/Linear/Mmap");
+BENCHMARK(
+    BM_FirstTouch<LinearMapped, MapOptions{HugePages::TRANSPARENT, false}>)
+    ->Name("BM_FirstTouch/Linear/MmapTransparent");
+BENCHMARK(BM_FirstTouch<LinearMapped, MapOptions{HugePages::TRANSPARENT, true}>)
+    ->Name("BM_FirstTouch/Linear/MmapPopulate");
+
+}  // namespace allocator::perf
@@ -0,0 +1,103 @@
+#include "pool_allocator.h"
+
+#include <benchmark/benchmark.h>
+
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "benchmark_setup.h"
+
+namespace allocator::perf {
+inline constexpr size_t POOL_BLOCK{64};
+
+using PoolHeap = PoolAllocator<POOL_BLOCK, CAPACITY / POOL_BLOCK>;
+using PoolStack =
+    PoolAllocator<POOL_BLOCK, CAPACITY / POOL_BLOCK, BufferType::STACK>;
+using PoolExternal =
+    PoolAllocator<POOL_BLOCK, CAPACITY / POOL_BLOCK, BufferType::EXTERNAL>;
+using PoolOwned = PoolAllocator<POOL_BLOCK, CAPACITY / POOL_BLOCK,
+                                BufferType::HEAP, Concurrency::OWNER>;
+
+// the baseline remote frees replace, one lock taken by both threads
+struct PoolLocked {
+  std::byte* allocate() {
+    std::lock_guard lock{mutex};
+    return pool.allocate();
+  }
+
+  void deallocate(std::byte* ptr) {
+    std::lock_guard lock{mutex};
+    pool.deallocate(ptr);
+  }
+
+  std::mutex mutex{};
+  PoolHeap pool{};
+};
+
+// every block is freed as if by another thread, through the remote free
+// list or the lock. the owner is made a thread that has already exited,
+// and with nothing else running this one allocates in its place, so the
+// cost of the cross-thread path is measured without scheduling noise
+template <typename Allocator>
+inline void BM_ForeignFree(::benchmark::State& state) {
+  auto alloc{std::make_unique<Allocator>()};
+  if constexpr (requires { alloc->set_owner(); }) {
+    std::thread{[&alloc] { alloc->set_owner(); }}.join();
+  }
+
+  std::byte* blocks[ROUNDS];
+  for (auto _ : state) {
+    for (auto& block : blocks) {
+      block = alloc->allocate();
+    }
+    ::benchmark::DoNotOptimize(blocks);
+
+    for (auto* block : blocks) {
+      alloc->deallocate(block);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * ROUNDS);
+}
+
+//////////////////////////////
+// allocation benchmarks
+//////////////////////////////
+
+BENCHMARK(BM_Allocation<PoolHeap>)->Name("BM_Allocation/Pool/Heap");
+BENCHMARK(BM_Allocation<PoolStack>)->Name("BM_Allocation/Pool/Stack");
+BENCHMARK(BM_Allocation<PoolExternal>)->Name("BM_Allocation/Pool/External");
+
+//////////////////////////////
+// emplace benchmarks
+//////////////////////////////
+
+BENCHMARK(BM_Emplace<PoolHeap>)->Name("BM_Emplace/Pool/Heap");
+BENCHMARK(BM_Emplace<PoolStack>)->Name("BM_Emplace/Pool/Stack");
+BENCHMARK(BM_Emplace<PoolExternal>)->Name("BM_Emplace/Pool/External");
+
+//////////////////////////////
+// workload benchmarks
+//////////////////////////////
+
+BENCHMARK(BM_Workload<PoolHeap>)->Name("BM_Workload/Pool/Heap");
+BENCHMARK(BM_Workload<PoolStack>)->Name("BM_Workload/Pool/Stack");
+BENCHMARK(BM_Workload<PoolExternal>)->Name("BM_Workload/Pool/External");
+
+//////////////////////////////
+// churn benchmarks
+//////////////////////////////
+
+BENCHMARK(BM_Churn<PoolHeap>)->Name("BM_Churn/Pool/Heap");
+BENCHMARK(BM_Churn<PoolStack>)->Name("BM_Churn/Pool/Stack");
+BENCHMARK(BM_Churn<PoolExternal>)->Name("BM_Churn/Pool/External");
+BENCHMARK(BM_Churn<PoolOwned>)->Name("BM_Churn/Pool/Owned");
+
+//////////////////////////////
+// cross-thread benchmarks
+//////////////////////////////
+
+BENCHMARK(BM_ForeignFree<PoolOwned>)->Name("BM_ForeignFree/Pool/Owned");
+BENCHMARK(BM_ForeignFree<PoolLocked>)->Name("BM_ForeignFree/Pool/Mutex");
+
+}  // namespace allocator::perf
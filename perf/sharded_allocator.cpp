@@ -0,0 +1,84 @@
+#include "sharded_allocator.h"
+
+#include <benchmark/benchmark.h>
+
+#include <memory>
+#include <mutex>
+
+#include "benchmark_setup.h"
+#include "free_list_allocator.h"
+
+namespace allocator::perf {
+// threads allocating and freeing a batch of mixed sizes from one arena
+inline constexpr size_t SHARDED_CAPACITY{size_t{1} << 24};
+inline constexpr size_t SHARDED_BATCH{16};
+inline constexpr size_t SHARDED_SIZES[]{32, 64, 256, 1024};
+
+using FreeListShard = FreeListAllocator<dynamic_extent, BufferType::EXTERNAL>;
+
+using ShardedByCpu = ShardedAllocator<FreeListShard, 8>;
+using ShardedByThread =
+    ShardedAllocator<FreeListShard, 8, BufferType::HEAP, Affinity::THREAD>;
+
+// the baseline sharding replaces, one lock around a single free list
+struct LockedFreeList {
+  explicit LockedFreeList(size_t size) : backend(size) {}
+
+  std::byte* allocate(size_t size, size_t alignment) {
+    std::lock_guard lock{mutex};
+    return backend.allocate(size, alignment);
+  }
+
+  void deallocate(std::byte* ptr) {
+    std::lock_guard lock{mutex};
+    backend.deallocate(ptr);
+  }
+
+  std::mutex mutex{};
+  FreeListAllocator<dynamic_extent> backend;
+};
+
+//////////////////////////////
+// multithreaded benchmarks
+//////////////////////////////
+
+template <typename Allocator>
+inline void BM_Sharded(::benchmark::State& state) {
+  static std::unique_ptr<Allocator> alloc{};
+  if (state.thread_index() == 0) {
+    alloc = std::make_unique<Allocator>(SHARDED_CAPACITY);
+  }
+
+  std::byte* pointers[SHARDED_BATCH]{};
+  for (auto _ : state) {
+    for (size_t i{}; i < SHARDED_BATCH; ++i) {
+      pointers[i] = alloc->allocate(SHARDED_SIZES[i % 4], 8);
+    }
+    // whole array, per element "+m,r" constraints miscompile under gcc -O2
+    ::benchmark::DoNotOptimize(pointers);
+
+    for (auto* ptr : pointers) {
+      alloc->deallocate(ptr);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * SHARDED_BATCH);
+
+  if (state.thread_index() == 0) {
+    alloc.reset();
+  }
+}
+
+BENCHMARK(BM_Sharded<ShardedByCpu>)
+    ->Name("BM_Sharded/FreeList/ByCpu")
+    ->ThreadRange(1, 8)
+    ->UseRealTime();
+BENCHMARK(BM_Sharded<ShardedByThread>)
+    ->Name("BM_Sharded/FreeList/ByThread")
+    ->ThreadRange(1, 8)
+    ->UseRealTime();
+BENCHMARK(BM_Sharded<LockedFreeList>)
+    ->Name("BM_Sharded/FreeList/Mutex")
+    ->ThreadRange(1, 8)
+    ->UseRealTime();
+
+}  // namespace allocator::perf
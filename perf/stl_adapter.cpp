@@ -0,0 +1,90 @@
+#include "stl_adapter.h"
+
+#include <benchmark/benchmark.h>
+
+#include <functional>
+#include <list>
+#include <map>
+#include <memory>
+#include <utility>
+
+#include "benchmark_setup.h"
+#include "buddy_allocator.h"
+#include "free_list_allocator.h"
+
+namespace allocator::perf {
+using FreeListHeap = FreeListAllocator<CAPACITY>;
+using BuddyHeap = BuddyAllocator<CAPACITY>;
+
+template <typename Adapter>
+using Map = std::map<int, int, std::less<int>,
+                     typename std::allocator_traits<Adapter>::template
+                         rebind_alloc<std::pair<const int, int>>>;
+
+template <typename Adapter>
+using List = std::list<
+    int, typename std::allocator_traits<Adapter>::template rebind_alloc<int>>;
+
+// fills and tears down a node-based container, one allocation per element
+template <typename Container, typename Adapter>
+inline void fill(const Adapter& adapter) {
+  Container container(adapter);
+  for (int i{}; i < ROUNDS; ++i) {
+    if constexpr (requires { container.emplace(i, i); }) {
+      container.emplace(i, i);
+    } else {
+      container.push_back(i);
+    }
+  }
+  ::benchmark::DoNotOptimize(container.size());
+}
+
+template <typename Allocator>
+inline void BM_Map(::benchmark::State& state) {
+  Setup<Allocator> setup{};
+  StlAdapter<int, Allocator> adapter{*setup.alloc};
+
+  for (auto _ : state) {
+    fill<Map<StlAdapter<int, Allocator>>>(adapter);
+  }
+  state.SetItemsProcessed(state.iterations() * ROUNDS);
+}
+
+template <typename Allocator>
+inline void BM_List(::benchmark::State& state) {
+  Setup<Allocator> setup{};
+  StlAdapter<int, Allocator> adapter{*setup.alloc};
+
+  for (auto _ : state) {
+    fill<List<StlAdapter<int, Allocator>>>(adapter);
+  }
+  state.SetItemsProcessed(state.iterations() * ROUNDS);
+}
+
+static void BM_Map_Default(::benchmark::State& state) {
+  for (auto _ : state) {
+    fill<Map<std::allocator<int>>>(std::allocator<int>{});
+  }
+  state.SetItemsProcessed(state.iterations() * ROUNDS);
+}
+
+static void BM_List_Default(::benchmark::State& state) {
+  for (auto _ : state) {
+    fill<List<std::allocator<int>>>(std::allocator<int>{});
+  }
+  state.SetItemsProcessed(state.iterations() * ROUNDS);
+}
+
+//////////////////////////////
+// node container benchmarks
+//////////////////////////////
+
+BENCHMARK(BM_Map<FreeListHeap>)->Name("BM_Map/FreeList/Heap/FirstFit");
+BENCHMARK(BM_Map<BuddyHeap>)->Name("BM_Map/Buddy/Heap");
+BENCHMARK(BM_Map_Default)->Name("BM_Map/STL/Default");
+
+BENCHMARK(BM_List<FreeListHeap>)->Name("BM_List/FreeList/Heap/FirstFit");
+BENCHMARK(BM_List<BuddyHeap>)->Name("BM_List/Buddy/Heap");
+BENCHMARK(BM_List_Default)->Name("BM_List/STL/Default");
+
+}  // namespace allocator::perf
@@ -0,0 +1,112 @@
+#include "thread_cache_allocator.h"
+
+#include <benchmark/benchmark.h>
+
+#include <cstdlib>
+#include <mutex>
+
+#include "benchmark_setup.h"
+#include "buddy_allocator.h"
+#include "free_list_allocator.h"
+
+namespace allocator::perf {
+inline constexpr size_t SHARED_CAPACITY{size_t{1} << 24};
+inline constexpr int MAX_THREADS{32};
+
+using ThreadCacheFreeList =
+    ThreadCacheAllocator<FreeListAllocator<SHARED_CAPACITY>>;
+using ThreadCacheBuddy = ThreadCacheAllocator<BuddyAllocator<SHARED_CAPACITY>>;
+
+// the baseline a thread cache replaces, one lock around the whole backend
+template <typename Backend>
+struct Locked {
+  std::mutex mutex{};
+  Backend backend{};
+
+  std::byte* allocate(size_t size) {
+    std::lock_guard lock{mutex};
+    if constexpr (requires { backend.allocate(size, 8); }) {
+      return backend.allocate(size, 8);
+    } else {
+      return backend.allocate(size);
+    }
+  }
+
+  void deallocate(std::byte* ptr, size_t) {
+    std::lock_guard lock{mutex};
+    backend.deallocate(ptr);
+  }
+};
+
+using LockedFreeList = Locked<FreeListAllocator<SHARED_CAPACITY>>;
+using LockedBuddy = Locked<BuddyAllocator<SHARED_CAPACITY>>;
+
+//////////////////////////////
+// multithreaded benchmarks
+//////////////////////////////
+
+template <typename Allocator>
+inline void BM_Threaded(::benchmark::State& state) {
+  static std::unique_ptr<Allocator> alloc{};
+  if (state.thread_index() == 0) {
+    alloc = std::make_unique<Allocator>();
+  }
+
+  std::byte* blocks[ROUNDS];
+  for (auto _ : state) {
+    for (int i{}; i < ROUNDS; ++i) {
+      blocks[i] = alloc->allocate(64);
+    }
+    // whole array, per element "+m,r" constraints miscompile under gcc -O2
+    ::benchmark::DoNotOptimize(blocks);
+
+    for (int i{}; i < ROUNDS; ++i) {
+      alloc->deallocate(blocks[i], 64);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * ROUNDS);
+
+  if (state.thread_index() == 0) {
+    alloc.reset();
+  }
+}
+
+static void BM_Threaded_Malloc(::benchmark::State& state) {
+  void* blocks[ROUNDS];
+  for (auto _ : state) {
+    for (int i{}; i < ROUNDS; ++i) {
+      blocks[i] = std::malloc(64);
+    }
+    ::benchmark::DoNotOptimize(blocks);
+
+    for (int i{}; i < ROUNDS; ++i) {
+      std::free(blocks[i]);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * ROUNDS);
+}
+
+BENCHMARK(BM_Threaded<ThreadCacheFreeList>)
+    ->Name("BM_Threaded/ThreadCache/FreeList")
+    ->ThreadRange(1, MAX_THREADS)
+    ->UseRealTime();
+BENCHMARK(BM_Threaded<ThreadCacheBuddy>)
+    ->Name("BM_Threaded/ThreadCache/Buddy")
+    ->ThreadRange(1, MAX_THREADS)
+    ->UseRealTime();
+
+BENCHMARK(BM_Threaded<LockedFreeList>)
+    ->Name("BM_Threaded/Locked/FreeList")
+    ->ThreadRange(1, MAX_THREADS)
+    ->UseRealTime();
+BENCHMARK(BM_Threaded<LockedBuddy>)
+    ->Name("BM_Threaded/Locked/Buddy")
+    ->ThreadRange(1, MAX_THREADS)
+    ->UseRealTime();
+
+BENCHMARK(BM_Threaded_Malloc)
+    ->Name("BM_Threaded/STL/Malloc")
+    ->ThreadRange(1, MAX_THREADS)
+    ->UseRealTime();
+
+}  // namespace allocator::perf
@@ -6,11 +6,13 @@
 
 using namespace allocator;
 constexpr size_t SIZE{1024};
-constexpr size_t ALIGNMENT{sizeof(Node)};
+constexpr size_t ALIGNMENT{alignof(std::max_align_t)};
 
-using Linear = LinearAllocator<SIZE, BufferType::HEAP>;
-using FreeList = FreeListAllocator<SIZE, BufferType::HEAP, FitStrategy::FIRST>;
-using Buddy = BuddyAllocator<SIZE, BufferType::HEAP>;
+// tracked, so the visualizer can show every individual allocation
+using Linear = LinearAllocator<SIZE, BufferType::HEAP, Tracking::DEBUG>;
+using FreeList = FreeListAllocator<SIZE, BufferType::HEAP, FitStrategy::FIRST,
+                                   Tracking::DEBUG>;
+using Buddy = BuddyAllocator<SIZE, BufferType::HEAP, Tracking::DEBUG>;
 
 EMSCRIPTEN_BINDINGS(allocators) {
   emscripten::class_<Linear>("LinearAllocator")
@@ -1,15 +1,24 @@
 #include "buddy_allocator.h"
 
 #include <gtest/gtest.h>
+#include <sys/mman.h>
+
+#include <algorithm>
+#include <random>
+#include <span>
+#include <thread>
+#include <utility>
+#include <vector>
 
 namespace allocator::tests {
 template <typename Allocator>
 class BuddyAllocatorTypedTest : public ::testing::Test {
  protected:
   void SetUp() override {
-    if constexpr (std::is_same_v<Allocator,
-                                 BuddyAllocator<1024, BufferType::EXTERNAL>>) {
+    if constexpr (Allocator::buffer_type == BufferType::EXTERNAL) {
       alloc = std::make_unique<Allocator>(buf);
+    } else if constexpr (Allocator::extent == dynamic_extent) {
+      alloc = std::make_unique<Allocator>(buf_size);
     } else {
       alloc = std::make_unique<Allocator>();
     }
@@ -17,15 +26,26 @@ class BuddyAllocatorTypedTest : public ::testing::Test {
 
   std::unique_ptr<Allocator> alloc{};
 
-  // for buffertype::external allocator
+  // for buffertype::external allocator, aligned so that aligned requests
+  // can be served from it too
   static constexpr size_t buf_size{1024};
-  std::array<std::byte, buf_size> buf{};
+  alignas(64) std::array<std::byte, buf_size> buf{};
 };
 
 using AllocatorTypes =
     ::testing::Types<BuddyAllocator<1024>,
                      BuddyAllocator<1024, BufferType::STACK>,
-                     BuddyAllocator<1024, BufferType::EXTERNAL>>;
+                     BuddyAllocator<1024, BufferType::EXTERNAL>,
+                     BuddyAllocator<1024, BufferType::HEAP, Tracking::DEBUG>,
+                     BuddyAllocator<1024, BufferType::MMAP>,
+                     BuddyAllocator<dynamic_extent>,
+                     BuddyAllocator<dynamic_extent, BufferType::EXTERNAL>,
+                     BuddyAllocator<dynamic_extent, BufferType::MMAP>,
+                     BuddyAllocator<1024, BufferType::STACK, Tracking::NONE,
+                                    Decommit::NONE, Concurrency::PER_LEVEL>,
+                     BuddyAllocator<dynamic_extent, BufferType::HEAP,
+                                    Tracking::NONE, Decommit::INLINE,
+                                    Concurrency::PER_LEVEL>>;
 
 TYPED_TEST_SUITE(BuddyAllocatorTypedTest, AllocatorTypes);
 
@@ -53,6 +73,38 @@ TYPED_TEST(BuddyAllocatorTypedTest, ReturnsNullptrWhenOutOfMemory) {
   EXPECT_EQ(ptr, nullptr);
 }
 
+TYPED_TEST(BuddyAllocatorTypedTest, AlignsWithoutWastingLevel) {
+  auto* ptr1{this->alloc->allocate(16)};
+  auto* ptr2{this->alloc->allocate(16, 64)};
+
+  ASSERT_NE(ptr1, nullptr);
+  ASSERT_NE(ptr2, nullptr);
+
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(ptr2) % 64, 0);
+  EXPECT_EQ(this->alloc->get_used(), 32);
+}
+
+TYPED_TEST(BuddyAllocatorTypedTest, FindsAlignedSmallerBlock) {
+  ASSERT_NE(this->alloc->allocate(512), nullptr);
+  ASSERT_NE(this->alloc->allocate(256), nullptr);
+
+  std::array<std::byte*, 16> small{};
+  for (auto& ptr : small) {
+    ptr = this->alloc->allocate(16);
+    ASSERT_NE(ptr, nullptr);
+  }
+
+  // only small[4], at offset 832, is free and on a 64 byte boundary
+  this->alloc->deallocate(small[4]);
+  this->alloc->deallocate(small[7]);
+
+  EXPECT_EQ(this->alloc->allocate(16, 64), small[4]);
+}
+
+TYPED_TEST(BuddyAllocatorTypedTest, InvalidAligmentReturnsNullptr) {
+  EXPECT_EQ(this->alloc->allocate(16, 3), nullptr);
+}
+
 TYPED_TEST(BuddyAllocatorTypedTest, DeallocateNullptr) {
   auto* ptr1{this->alloc->allocate(100)};
   ASSERT_NE(ptr1, nullptr);
@@ -100,6 +152,35 @@ TYPED_TEST(BuddyAllocatorTypedTest, FullCoalescing) {
   EXPECT_NE(large, nullptr);
 }
 
+TYPED_TEST(BuddyAllocatorTypedTest, SizedDeallocateCoalesces) {
+  size_t alloc_size{this->buf_size / 4};
+
+  // alignment does not change the level, only where the block may sit
+  auto* ptr1{this->alloc->allocate(alloc_size - 1)};
+  auto* ptr2{this->alloc->allocate(100, 64)};
+  auto* ptr3{this->alloc->allocate(alloc_size)};
+
+  ASSERT_NE(ptr1, nullptr);
+  ASSERT_NE(ptr2, nullptr);
+  ASSERT_NE(ptr3, nullptr);
+
+  this->alloc->deallocate(ptr2, 100, 64);
+  this->alloc->deallocate(ptr1, alloc_size - 1, 1);
+  this->alloc->deallocate(ptr3, alloc_size, 1);
+  EXPECT_EQ(this->alloc->get_used(), 0);
+
+  auto* whole{this->alloc->allocate(this->buf_size)};
+  EXPECT_NE(whole, nullptr);
+}
+
+TYPED_TEST(BuddyAllocatorTypedTest, SizedDeallocateChecksSize) {
+  auto* ptr{this->alloc->allocate(64)};
+  ASSERT_NE(ptr, nullptr);
+
+  EXPECT_DEATH(this->alloc->deallocate(ptr, this->buf_size / 2, 8),
+               "size does not match the allocation");
+}
+
 TYPED_TEST(BuddyAllocatorTypedTest, PartialCoalescing) {
   size_t alloc_size{this->buf_size / 4};
 
@@ -123,6 +204,226 @@ TYPED_TEST(BuddyAllocatorTypedTest, PartialCoalescing) {
   EXPECT_EQ(this->alloc->get_used(), 0);
 }
 
+TYPED_TEST(BuddyAllocatorTypedTest, ExhaustsEveryLevel) {
+  constexpr size_t count{TestFixture::buf_size / sizeof(Block)};
+  std::array<std::byte*, count> ptrs{};
+
+  for (auto& ptr : ptrs) {
+    ptr = this->alloc->allocate(sizeof(Block));
+    ASSERT_NE(ptr, nullptr);
+  }
+  EXPECT_EQ(this->alloc->allocate(sizeof(Block)), nullptr);
+
+  for (auto* ptr : ptrs) {
+    this->alloc->deallocate(ptr);
+  }
+
+  EXPECT_NE(this->alloc->allocate(this->buf_size), nullptr);
+}
+
+TYPED_TEST(BuddyAllocatorTypedTest, RandomChurnKeepsBlocksIntact) {
+  std::mt19937 rng{42};
+  std::vector<std::pair<std::byte*, size_t>> live{};
+
+  for (int i{}; i < 5000; ++i) {
+    if (live.empty() || rng() % 2 == 0) {
+      size_t size{1 + rng() % 128};
+      std::byte* ptr{this->alloc->allocate(size)};
+      if (ptr) {
+        std::fill_n(ptr, size, static_cast<std::byte>(size));
+        live.emplace_back(ptr, size);
+      }
+    } else {
+      size_t index{rng() % live.size()};
+      auto [ptr, size] = live[index];
+      for (size_t j{}; j < size; ++j) {
+        ASSERT_EQ(ptr[j], static_cast<std::byte>(size));
+      }
+
+      this->alloc->deallocate(ptr);
+      live[index] = live.back();
+      live.pop_back();
+    }
+  }
+
+  for (auto [ptr, size] : live) {
+    this->alloc->deallocate(ptr);
+  }
+
+  EXPECT_EQ(this->alloc->get_used(), 0);
+  EXPECT_NE(this->alloc->allocate(this->buf_size), nullptr);
+}
+
+TYPED_TEST(BuddyAllocatorTypedTest, ReallocateShrinksByFreeingUpperHalves) {
+  auto* ptr{this->alloc->allocate(512)};
+  ASSERT_NE(ptr, nullptr);
+  std::fill_n(ptr, 64, std::byte{0x5a});
+
+  auto* shrunk{this->alloc->reallocate(ptr, 64, 1)};
+  EXPECT_EQ(shrunk, ptr);
+  EXPECT_EQ(this->alloc->get_used(), 64);
+  EXPECT_TRUE(std::all_of(shrunk, shrunk + 64,
+                          [](std::byte b) { return b == std::byte{0x5a}; }));
+
+  // each upper half is free on its own level
+  EXPECT_EQ(this->alloc->allocate(256), ptr + 256);
+  EXPECT_EQ(this->alloc->allocate(128), ptr + 128);
+  EXPECT_EQ(this->alloc->allocate(64), ptr + 64);
+}
+
+TYPED_TEST(BuddyAllocatorTypedTest, ReallocateGrowsIntoFreeBuddies) {
+  auto* ptr{this->alloc->allocate(64)};
+  ASSERT_NE(ptr, nullptr);
+  std::fill_n(ptr, 64, std::byte{0x5a});
+
+  auto* grown{this->alloc->reallocate(ptr, 256, 1)};
+  EXPECT_EQ(grown, ptr);
+  EXPECT_EQ(this->alloc->get_used(), 256);
+  EXPECT_TRUE(std::all_of(grown, grown + 64,
+                          [](std::byte b) { return b == std::byte{0x5a}; }));
+
+  // the same size stays put, and the grown block frees as one
+  EXPECT_EQ(this->alloc->reallocate(grown, 200, 1), grown);
+  this->alloc->deallocate(grown);
+  EXPECT_EQ(this->alloc->get_used(), 0);
+  EXPECT_NE(this->alloc->allocate(this->buf_size), nullptr);
+}
+
+TYPED_TEST(BuddyAllocatorTypedTest, ReallocateMovesWhenBuddyIsTaken) {
+  auto* lower{this->alloc->allocate(64)};
+  auto* upper{this->alloc->allocate(64)};
+  ASSERT_EQ(upper, lower + 64);
+  std::fill_n(upper, 64, std::byte{0x5a});
+
+  // an upper half has no buddy after it to grow into
+  auto* moved{this->alloc->reallocate(upper, 128, 1)};
+  ASSERT_NE(moved, nullptr);
+  EXPECT_NE(moved, upper);
+  EXPECT_TRUE(std::all_of(moved, moved + 64,
+                          [](std::byte b) { return b == std::byte{0x5a}; }));
+  EXPECT_EQ(this->alloc->get_used(), 64 + 128);
+
+  // and a lower half cannot take an allocated one
+  EXPECT_EQ(this->alloc->reallocate(lower, this->buf_size, 1), nullptr);
+  EXPECT_EQ(this->alloc->get_used(), 64 + 128);
+
+  this->alloc->deallocate(lower);
+  this->alloc->deallocate(moved);
+  EXPECT_EQ(this->alloc->get_used(), 0);
+  EXPECT_NE(this->alloc->allocate(this->buf_size), nullptr);
+}
+
+TYPED_TEST(BuddyAllocatorTypedTest, ReallocateKeepsAlignmentWhenMoved) {
+  auto* ptr{this->alloc->allocate(16, 64)};
+  auto* buddy{this->alloc->allocate(16)};
+  ASSERT_EQ(buddy, ptr + 16);
+  *ptr = std::byte{0x5a};
+
+  // the first free 32 byte block is ptr + 32, which is not aligned
+  auto* moved{this->alloc->reallocate(ptr, 32, 64)};
+  ASSERT_NE(moved, nullptr);
+  EXPECT_NE(moved, ptr);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(moved) % 64, 0);
+  EXPECT_EQ(*moved, std::byte{0x5a});
+
+  this->alloc->deallocate(moved, 32, 64);
+  this->alloc->deallocate(buddy);
+  EXPECT_EQ(this->alloc->get_used(), 0);
+}
+
+TYPED_TEST(BuddyAllocatorTypedTest, AllocateBulkYieldsSiblings) {
+  std::array<std::byte*, 6> blocks{};
+  ASSERT_EQ(this->alloc->allocate_bulk(6, 64, 1, blocks), 6);
+
+  // split from one block, so they sit side by side
+  for (size_t i{1}; i < blocks.size(); ++i) {
+    EXPECT_EQ(blocks[i] - blocks[i - 1], 64);
+  }
+  EXPECT_EQ(this->alloc->get_used(), 6 * 64);
+
+  // what the split left over is still usable
+  auto* ptr{this->alloc->allocate(128)};
+  EXPECT_EQ(ptr, blocks.back() + 64);
+  EXPECT_NE(this->alloc->allocate(512), nullptr);
+
+  this->alloc->deallocate(ptr);
+  this->alloc->deallocate_bulk(blocks);
+  EXPECT_EQ(this->alloc->get_used(), 512);
+}
+
+TYPED_TEST(BuddyAllocatorTypedTest, AllocateBulkCoalescesFully) {
+  auto* ptr{this->alloc->allocate(256)};
+  ASSERT_NE(ptr, nullptr);
+
+  std::array<std::byte*, 64> blocks{};
+  size_t count{this->alloc->allocate_bulk(64, 48, 1, blocks)};
+  EXPECT_EQ(count, (this->buf_size - 256) / 64);
+  EXPECT_EQ(this->alloc->allocate(1), nullptr);
+
+  this->alloc->deallocate(ptr);
+  this->alloc->deallocate_bulk(std::span{blocks}.first(count));
+  EXPECT_EQ(this->alloc->get_used(), 0);
+  EXPECT_NE(this->alloc->allocate(this->buf_size), nullptr);
+}
+
+TYPED_TEST(BuddyAllocatorTypedTest, AllocateBulkTakesMinimumBlocks) {
+  // leaves a free minimum block behind, which the bulk request takes first
+  auto* ptr{this->alloc->allocate(16)};
+  ASSERT_NE(ptr, nullptr);
+
+  std::array<std::byte*, 4> blocks{};
+  ASSERT_EQ(this->alloc->allocate_bulk(1, 16, 1, blocks), 1);
+  EXPECT_EQ(blocks[0], ptr + 16);
+  ASSERT_EQ(this->alloc->allocate_bulk(3, 16, 1, std::span{blocks}.subspan(1)),
+            3);
+  EXPECT_EQ(this->alloc->get_used(), 4 * 16 + 16);
+
+  this->alloc->deallocate(ptr);
+  this->alloc->deallocate_bulk(blocks);
+  EXPECT_EQ(this->alloc->get_used(), 0);
+  EXPECT_NE(this->alloc->allocate(this->buf_size), nullptr);
+}
+
+TYPED_TEST(BuddyAllocatorTypedTest, DeallocateBulkMergesInAnyOrder) {
+  std::array<std::byte*, 16> blocks{};
+  ASSERT_EQ(this->alloc->allocate_bulk(16, 64, 1, blocks), 16);
+
+  // pairs out of order, then shuffled, with nullptr skipped
+  std::vector<std::byte*> order(blocks.rbegin(), blocks.rend());
+  std::shuffle(order.begin() + 8, order.end(), std::mt19937{42});
+  order.insert(order.begin() + 4, nullptr);
+
+  this->alloc->deallocate_bulk(order);
+  EXPECT_EQ(this->alloc->get_used(), 0);
+  EXPECT_NE(this->alloc->allocate(this->buf_size), nullptr);
+}
+
+TYPED_TEST(BuddyAllocatorTypedTest, AllocateBulkRoundsUpToAlignment) {
+  std::array<std::byte*, 3> blocks{};
+  ASSERT_EQ(this->alloc->allocate_bulk(3, 16, 64, blocks), 3);
+
+  for (std::byte* block : blocks) {
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(block) % 64, 0);
+  }
+  EXPECT_EQ(this->alloc->get_used(), 3 * 64);
+}
+
+TYPED_TEST(BuddyAllocatorTypedTest, SizedDeallocateFreesBulkBlocks) {
+  // the bulk blocks are rounded up to the alignment, the single one isn't
+  std::array<std::byte*, 4> blocks{};
+  ASSERT_EQ(this->alloc->allocate_bulk(4, 16, 64, blocks), 4);
+  auto* ptr{this->alloc->allocate(16, 64)};
+  ASSERT_NE(ptr, nullptr);
+  EXPECT_EQ(this->alloc->get_used(), 4 * 64 + 16);
+
+  for (std::byte* block : blocks) {
+    this->alloc->deallocate(block, 16, 64);
+  }
+  this->alloc->deallocate(ptr, 16, 64);
+  EXPECT_EQ(this->alloc->get_used(), 0);
+  EXPECT_NE(this->alloc->allocate(this->buf_size), nullptr);
+}
+
 TYPED_TEST(BuddyAllocatorTypedTest, ResetsSuccessfully) {
   auto* ptr1{this->alloc->allocate(500)};
   ASSERT_NE(ptr1, nullptr);
@@ -189,4 +490,206 @@ TYPED_TEST(BuddyAllocatorTypedTest, DestroyCallsDestructor) {
   EXPECT_EQ(TrackedObj::destructor_calls, 3);
 }
 
+
+TYPED_TEST(BuddyAllocatorTypedTest, GetStateReportsBlocks) {
+  auto* ptr1{this->alloc->allocate(100)};
+  auto* ptr2{this->alloc->allocate(100)};
+  auto* ptr3{this->alloc->allocate(100)};
+
+  ASSERT_NE(ptr1, nullptr);
+  ASSERT_NE(ptr2, nullptr);
+  ASSERT_NE(ptr3, nullptr);
+
+  this->alloc->deallocate(ptr2);
+
+  // 128 | free 128 | 128 | free 128 | free 512
+  std::string state{this->alloc->get_state()};
+  EXPECT_EQ(count_occurrences(state, "\"status\":\"used\""), 2);
+  EXPECT_EQ(count_occurrences(state, "\"status\":\"free\""), 3);
+}
+
+TEST(BuddyAllocatorTest, LargeArenaKeepsMetadataOutOfLine) {
+  using Large = BuddyAllocator<size_t{1} << 26>;
+  EXPECT_LT(sizeof(Large), 4096);
+
+  auto alloc{std::make_unique<Large>()};
+  auto* ptr{alloc->allocate(size_t{1} << 25)};
+  ASSERT_NE(ptr, nullptr);
+
+  alloc->deallocate(ptr);
+  EXPECT_EQ(alloc->get_used(), 0);
+}
+
+TEST(BuddyAllocatorTest, RuntimeCapacityRoundsDownToPowerOfTwo) {
+  BuddyAllocator<dynamic_extent> alloc{1500};
+  EXPECT_EQ(alloc.get_free(), 1024);
+
+  EXPECT_NE(alloc.allocate(1024), nullptr);
+  EXPECT_EQ(alloc.allocate(16), nullptr);
+}
+
+TEST(BuddyAllocatorTest, AlignsExternalBufferWithSpareBytes) {
+  // 8 bytes past a 64 byte boundary, with room to skip to the next one
+  alignas(64) std::array<std::byte, 2048> storage{};
+  BuddyAllocator<dynamic_extent, BufferType::EXTERNAL> alloc{
+      std::span{storage}.subspan(8, 1100)};
+  EXPECT_EQ(alloc.get_free(), 1024);
+
+  struct alignas(64) Aligned {
+    int value;
+  };
+  auto* obj{alloc.allocate<Aligned>()};
+  ASSERT_NE(obj, nullptr);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(obj) % 64, 0);
+}
+
+TEST(BuddyAllocatorTest, AlignsBeyondExternalBufferByAddress) {
+  // data starts 16 bytes past a 64 byte boundary, so no level is aligned
+  alignas(64) std::array<std::byte, 2048> storage{};
+  BuddyAllocator<dynamic_extent, BufferType::EXTERNAL> alloc{
+      std::span{storage}.subspan(16, 1024)};
+
+  auto* ptr{alloc.allocate(16, 64)};
+  ASSERT_NE(ptr, nullptr);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(ptr) % 64, 0);
+  EXPECT_EQ(alloc.get_used(), 16);
+
+  // blocks larger than the buffer's alignment can never be aligned
+  EXPECT_EQ(alloc.allocate(64, 64), nullptr);
+
+  alloc.deallocate(ptr);
+  EXPECT_EQ(alloc.get_used(), 0);
+  EXPECT_NE(alloc.allocate(1024), nullptr);
+}
+
+TEST(BuddyAllocatorTest, AlignsMisalignedExternalBuffer) {
+  // the first 8 bytes are skipped, which halves the power of 2 capacity
+  alignas(16) std::array<std::byte, 1032> storage{};
+  BuddyAllocator<dynamic_extent, BufferType::EXTERNAL> alloc{
+      std::span{storage}.subspan(8)};
+  EXPECT_EQ(alloc.get_free(), 512);
+
+  auto* ptr{alloc.allocate(16)};
+  ASSERT_NE(ptr, nullptr);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(ptr) % alignof(std::max_align_t), 0);
+}
+
+TEST(BuddyAllocatorTest, AlignsBeyondPageSize) {
+  auto alloc{std::make_unique<BuddyAllocator<size_t{1} << 16>>()};
+  auto* ptr{alloc->allocate(100, 2 * page_size)};
+  ASSERT_NE(ptr, nullptr);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(ptr) % (2 * page_size), 0);
+}
+
+// pages of [ptr, ptr + size) currently backed by memory
+inline size_t resident_pages(std::byte* ptr, size_t size) {
+  std::vector<unsigned char> pages(size / page_size);
+  if (::mincore(ptr, size, pages.data()) != 0) {
+    return SIZE_MAX;
+  }
+  return static_cast<size_t>(std::ranges::count_if(
+      pages, [](unsigned char page) { return page & 1; }));
+}
+
+TEST(BuddyAllocatorTest, TrimReleasesFreePagesButKeepsLinks) {
+  constexpr size_t capacity{size_t{1} << 20};
+  BuddyAllocator<capacity, BufferType::MMAP> alloc{
+      MapOptions{HugePages::NONE, false}};
+
+  // touch the whole buffer, then free it in pieces that coalesce
+  std::vector<std::byte*> pointers{};
+  for (size_t i{}; i < 16; ++i) {
+    pointers.push_back(alloc.allocate(capacity / 16));
+    ASSERT_NE(pointers.back(), nullptr);
+    std::fill_n(pointers.back(), capacity / 16, std::byte{1});
+  }
+  std::byte* base{pointers.front()};
+  EXPECT_EQ(resident_pages(base, capacity), capacity / page_size);
+
+  // the first quarter stays live and resident
+  for (size_t i{4}; i < 16; ++i) {
+    alloc.deallocate(pointers[i]);
+  }
+  EXPECT_EQ(alloc.trim(), capacity * 3 / 4 - 2 * page_size);
+  EXPECT_EQ(resident_pages(base, capacity), capacity / 4 / page_size + 2);
+
+  // below the threshold, nothing is released
+  alloc.deallocate(pointers[0]);
+  EXPECT_EQ(alloc.trim(capacity), 0);
+
+  // released pages are usable again, and read back as zero
+  std::byte* ptr{alloc.allocate(capacity / 2)};
+  ASSERT_NE(ptr, nullptr);
+  EXPECT_EQ(ptr[capacity / 4], std::byte{0});
+  EXPECT_EQ(alloc.allocate(capacity / 4), base + capacity / 4);
+}
+
+TEST(BuddyAllocatorTest, InlineDecommitOnCoalesce) {
+  constexpr size_t capacity{size_t{1} << 20};
+  BuddyAllocator<capacity, BufferType::MMAP, Tracking::NONE, Decommit::INLINE>
+      alloc{MapOptions{HugePages::NONE, false}};
+
+  std::byte* small{alloc.allocate(page_size)};
+  std::byte* large{alloc.allocate(capacity / 2)};
+  ASSERT_NE(small, nullptr);
+  ASSERT_NE(large, nullptr);
+  std::fill_n(large, capacity / 2, std::byte{1});
+  std::fill_n(small, page_size, std::byte{1});
+
+  // the large block goes as soon as it is freed, its first page stays
+  alloc.deallocate(large);
+  EXPECT_EQ(resident_pages(large, capacity / 2), 1);
+
+  // small blocks below the threshold are left resident
+  alloc.deallocate(small);
+  EXPECT_EQ(resident_pages(small, page_size), 1);
+  EXPECT_EQ(alloc.get_used(), 0);
+}
+
+TEST(BuddyAllocatorTest, ConcurrentThreadsCoalesceFully) {
+  constexpr size_t capacity{size_t{1} << 20};
+  constexpr size_t thread_count{4};
+  BuddyAllocator<capacity, BufferType::HEAP, Tracking::NONE, Decommit::NONE,
+                 Concurrency::PER_LEVEL>
+      alloc{};
+
+  // random sizes keep every level splitting and merging across threads
+  std::vector<std::thread> workers{};
+  for (size_t t{}; t < thread_count; ++t) {
+    workers.emplace_back([&, t] {
+      std::mt19937 rng{static_cast<unsigned>(t)};
+      std::uniform_int_distribution<size_t> size_dist{16, 4096};
+      std::vector<std::pair<std::byte*, size_t>> live{};
+      auto tag{std::byte{static_cast<unsigned char>(t + 1)}};
+
+      for (size_t i{}; i < 20000; ++i) {
+        if (live.size() < 32 && rng() % 2 == 0) {
+          size_t size{size_dist(rng)};
+          std::byte* ptr{alloc.allocate(size)};
+          if (ptr) {
+            std::fill_n(ptr, size, tag);
+            live.emplace_back(ptr, size);
+          }
+        } else if (!live.empty()) {
+          auto [ptr, size]{live.back()};
+          live.pop_back();
+          // no other thread was handed any of this block
+          ASSERT_EQ(std::count(ptr, ptr + size, tag),
+                    static_cast<std::ptrdiff_t>(size));
+          alloc.deallocate(ptr);
+        }
+      }
+      for (auto [ptr, size] : live) {
+        alloc.deallocate(ptr);
+      }
+    });
+  }
+  for (auto& worker : workers) {
+    worker.join();
+  }
+
+  EXPECT_EQ(alloc.get_used(), 0);
+  EXPECT_NE(alloc.allocate(capacity), nullptr);
+}
+
 }  // namespace allocator::tests
\ No newline at end of file
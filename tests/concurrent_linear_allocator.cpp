@@ -0,0 +1,198 @@
+#include "concurrent_linear_allocator.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <memory>
+#include <span>
+#include <thread>
+#include <vector>
+
+namespace allocator::tests {
+template <typename Allocator>
+class ConcurrentLinearAllocatorTypedTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    if constexpr (Allocator::buffer_type == BufferType::EXTERNAL) {
+      alloc = std::make_unique<Allocator>(buf);
+    } else if constexpr (Allocator::extent == dynamic_extent) {
+      alloc = std::make_unique<Allocator>(buf_size);
+    } else {
+      alloc = std::make_unique<Allocator>();
+    }
+  }
+
+  std::unique_ptr<Allocator> alloc{};
+
+  // for buffertype::external allocator
+  static constexpr size_t buf_size{1024};
+  alignas(std::max_align_t) std::array<std::byte, buf_size> buf{};
+};
+
+using AllocatorTypes = ::testing::Types<
+    ConcurrentLinearAllocator<1024>,                        // heap
+    ConcurrentLinearAllocator<1024, BufferType::STACK>,     // stack
+    ConcurrentLinearAllocator<1024, BufferType::EXTERNAL>,  // external
+    ConcurrentLinearAllocator<1024, BufferType::MMAP>,      // mapped
+    ConcurrentLinearAllocator<dynamic_extent>,              // runtime
+    ConcurrentLinearAllocator<dynamic_extent, BufferType::EXTERNAL>>;
+
+TYPED_TEST_SUITE(ConcurrentLinearAllocatorTypedTest, AllocatorTypes);
+
+TYPED_TEST(ConcurrentLinearAllocatorTypedTest, BasicAllocation) {
+  auto* ptr1{this->alloc->allocate(100, 8)};
+  auto* ptr2{this->alloc->allocate(100, 8)};
+
+  ASSERT_NE(ptr1, nullptr);
+  ASSERT_NE(ptr2, nullptr);
+  EXPECT_EQ(ptr2 - ptr1, 112);  // padded to the granularity
+}
+
+TYPED_TEST(ConcurrentLinearAllocatorTypedTest, AlignsCorrectly) {
+  auto* ptr1{this->alloc->allocate(13, 1)};
+  auto* ptr2{this->alloc->allocate(50, 8)};
+  auto* ptr3{this->alloc->allocate(100, 64)};
+  auto* ptr4{this->alloc->allocate(10, 8)};
+
+  ASSERT_NE(ptr1, nullptr);
+  ASSERT_NE(ptr2, nullptr);
+  ASSERT_NE(ptr3, nullptr);
+  ASSERT_NE(ptr4, nullptr);
+
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(ptr2) % 8, 0);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(ptr3) % 64, 0);
+
+  // over-aligned requests keep later offsets on the granularity
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(ptr4) % TypeParam::granularity, 0);
+  EXPECT_GE(ptr4, ptr3 + 100);
+}
+
+TYPED_TEST(ConcurrentLinearAllocatorTypedTest, ReturnsNullptrWhenOutOfMemory) {
+  EXPECT_EQ(this->alloc->allocate(2000, 8), nullptr);
+  EXPECT_EQ(this->alloc->allocate(2000, 64), nullptr);
+}
+
+TYPED_TEST(ConcurrentLinearAllocatorTypedTest, FailedRequestKeepsTheTail) {
+  ASSERT_NE(this->alloc->allocate(512, 8), nullptr);
+  EXPECT_EQ(this->alloc->allocate(1000, 8), nullptr);
+
+  // the space the failed request overshot is still available
+  EXPECT_NE(this->alloc->allocate(256, 8), nullptr);
+  EXPECT_EQ(this->alloc->get_used(), 768);
+}
+
+TYPED_TEST(ConcurrentLinearAllocatorTypedTest, ResetsSuccessfully) {
+  auto* ptr1{this->alloc->allocate(500, 8)};
+  ASSERT_NE(ptr1, nullptr);
+
+  this->alloc->reset();
+  EXPECT_EQ(this->alloc->get_used(), 0);
+  EXPECT_EQ(this->alloc->allocate(500, 8), ptr1);
+}
+
+TYPED_TEST(ConcurrentLinearAllocatorTypedTest, RewindReleasesAfterMarker) {
+  ASSERT_NE(this->alloc->allocate(100, 8), nullptr);
+
+  auto marker{this->alloc->get_marker()};
+  auto* released{this->alloc->allocate(200, 8)};
+  ASSERT_NE(released, nullptr);
+  ASSERT_NE(this->alloc->allocate(300, 8), nullptr);
+
+  this->alloc->rewind(marker);
+  EXPECT_EQ(this->alloc->allocate(200, 8), released);
+}
+
+TYPED_TEST(ConcurrentLinearAllocatorTypedTest, InvalidAlignmentReturnsNullptr) {
+  EXPECT_EQ(this->alloc->allocate(100, 0), nullptr);
+  EXPECT_EQ(this->alloc->allocate(100, 3), nullptr);
+  EXPECT_EQ(this->alloc->allocate(100, 6), nullptr);
+}
+
+TYPED_TEST(ConcurrentLinearAllocatorTypedTest, EmplaceAndDestroy) {
+  TrackedObj::destructor_calls = 0;
+
+  Obj* obj{this->alloc->template emplace<Obj>(15, 3.14)};
+  ASSERT_NE(obj, nullptr);
+  EXPECT_EQ(obj->x, 15);
+  EXPECT_EQ(obj->y, 3.14);
+
+  TrackedObj* tracked{this->alloc->template emplace<TrackedObj>(10)};
+  ASSERT_NE(tracked, nullptr);
+  this->alloc->destroy(tracked);
+  EXPECT_EQ(TrackedObj::destructor_calls, 1);
+}
+
+TYPED_TEST(ConcurrentLinearAllocatorTypedTest, GetStateReportsUsedBytes) {
+  ASSERT_NE(this->alloc->allocate(100, 8), nullptr);
+  ASSERT_NE(this->alloc->allocate(50, 8), nullptr);
+
+  std::string state{this->alloc->get_state()};
+  EXPECT_NE(state.find("\"used\":176"), std::string::npos);  // 112 + 64
+  EXPECT_EQ(count_occurrences(state, "\"status\":\"used\""), 1);
+}
+
+TEST(ConcurrentLinearAllocatorTest, ThreadsNeverShareMemory) {
+  constexpr size_t thread_count{4};
+  constexpr size_t per_thread{2048};
+  ConcurrentLinearAllocator<dynamic_extent> alloc{thread_count * per_thread *
+                                                  64};
+
+  // mixes the fetch-add and compare-exchange paths
+  std::vector<std::vector<std::byte*>> pointers(thread_count);
+  std::vector<std::thread> workers{};
+  for (size_t t{}; t < thread_count; ++t) {
+    workers.emplace_back([&, t] {
+      for (size_t i{}; i < per_thread; ++i) {
+        std::byte* ptr{alloc.allocate(24, i % 4 == 0 ? 32 : 8)};
+        ASSERT_NE(ptr, nullptr);
+        std::fill_n(ptr, 24, std::byte{static_cast<unsigned char>(t)});
+        pointers[t].push_back(ptr);
+      }
+    });
+  }
+  for (auto& worker : workers) {
+    worker.join();
+  }
+
+  std::vector<std::byte*> all{};
+  for (size_t t{}; t < thread_count; ++t) {
+    for (std::byte* ptr : pointers[t]) {
+      EXPECT_EQ(ptr[23], std::byte{static_cast<unsigned char>(t)});
+      all.push_back(ptr);
+    }
+  }
+
+  // every allocation is at least 24 bytes away from the next
+  std::ranges::sort(all);
+  for (size_t i{1}; i < all.size(); ++i) {
+    ASSERT_GE(all[i] - all[i - 1], 24);
+  }
+}
+
+TEST(ConcurrentLinearAllocatorTest, ExhaustsWithoutLosingBytes) {
+  constexpr size_t thread_count{4};
+  ConcurrentLinearAllocator<4096> alloc{};
+
+  // every byte is handed out once, however the threads race
+  std::vector<size_t> counts(thread_count);
+  std::vector<std::thread> workers{};
+  for (size_t t{}; t < thread_count; ++t) {
+    workers.emplace_back([&, t] {
+      while (alloc.allocate(16, 16)) {
+        ++counts[t];
+      }
+    });
+  }
+  for (auto& worker : workers) {
+    worker.join();
+  }
+
+  size_t total{};
+  for (size_t count : counts) {
+    total += count;
+  }
+  EXPECT_EQ(total, 4096 / 16);
+  EXPECT_EQ(alloc.get_free(), 0);
+}
+
+}  // namespace allocator::tests
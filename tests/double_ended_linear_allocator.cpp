@@ -0,0 +1,157 @@
+#include "double_ended_linear_allocator.h"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <span>
+
+namespace allocator::tests {
+template <typename Allocator>
+class DoubleEndedLinearAllocatorTypedTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    if constexpr (Allocator::buffer_type == BufferType::EXTERNAL) {
+      alloc = std::make_unique<Allocator>(buf);
+    } else if constexpr (Allocator::extent == dynamic_extent) {
+      alloc = std::make_unique<Allocator>(buf_size);
+    } else {
+      alloc = std::make_unique<Allocator>();
+    }
+  }
+
+  std::unique_ptr<Allocator> alloc{};
+
+  // for buffertype::external allocator
+  static constexpr size_t buf_size{1024};
+  alignas(std::max_align_t) std::array<std::byte, buf_size> buf{};
+};
+
+using AllocatorTypes = ::testing::Types<
+    DoubleEndedLinearAllocator<1024>,                        // heap
+    DoubleEndedLinearAllocator<1024, BufferType::STACK>,     // stack
+    DoubleEndedLinearAllocator<1024, BufferType::EXTERNAL>,  // external
+    DoubleEndedLinearAllocator<1024, BufferType::HEAP,
+                               Tracking::DEBUG>,  // tracked
+    DoubleEndedLinearAllocator<1024, BufferType::MMAP>,  // mapped
+    DoubleEndedLinearAllocator<dynamic_extent>,          // runtime
+    DoubleEndedLinearAllocator<dynamic_extent, BufferType::EXTERNAL>,
+    DoubleEndedLinearAllocator<dynamic_extent, BufferType::MMAP>>;
+
+TYPED_TEST_SUITE(DoubleEndedLinearAllocatorTypedTest, AllocatorTypes);
+
+TYPED_TEST(DoubleEndedLinearAllocatorTypedTest, AllocatesFromBothEnds) {
+  auto* front1{this->alloc->allocate_front(100, 8)};
+  auto* front2{this->alloc->allocate_front(100, 8)};
+  auto* back1{this->alloc->allocate_back(100, 8)};
+  auto* back2{this->alloc->allocate_back(100, 8)};
+
+  ASSERT_NE(front1, nullptr);
+  ASSERT_NE(front2, nullptr);
+  ASSERT_NE(back1, nullptr);
+  ASSERT_NE(back2, nullptr);
+
+  // the front grows up and the back grows down
+  EXPECT_LT(front1, front2);
+  EXPECT_LT(back2, back1);
+  EXPECT_LE(front2 + 100, back2);
+  EXPECT_EQ(this->alloc->get_used(), (104 + 100) + (104 + 104));
+}
+
+TYPED_TEST(DoubleEndedLinearAllocatorTypedTest, AlignsBothEnds) {
+  auto* front{this->alloc->allocate_front(13, 1)};
+  auto* back1{this->alloc->allocate_back(13, 1)};
+  auto* back2{this->alloc->allocate_back(50, 16)};
+  auto* back3{this->alloc->allocate_back(100, 64)};
+
+  ASSERT_NE(front, nullptr);
+  ASSERT_NE(back1, nullptr);
+  ASSERT_NE(back2, nullptr);
+  ASSERT_NE(back3, nullptr);
+
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(back2) % 16, 0);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(back3) % 64, 0);
+  EXPECT_LE(back2 + 50, back1);
+  EXPECT_LE(back3 + 100, back2);
+}
+
+TYPED_TEST(DoubleEndedLinearAllocatorTypedTest, EndsShareCapacity) {
+  // either end can take nearly all of the buffer
+  auto* front{this->alloc->allocate_front(900, 8)};
+  ASSERT_NE(front, nullptr);
+  EXPECT_EQ(this->alloc->allocate_back(200, 8), nullptr);
+  EXPECT_NE(this->alloc->allocate_back(100, 8), nullptr);
+  EXPECT_EQ(this->alloc->allocate_front(100, 8), nullptr);
+
+  this->alloc->reset();
+  EXPECT_NE(this->alloc->allocate_back(900, 8), nullptr);
+  EXPECT_EQ(this->alloc->allocate_front(200, 8), nullptr);
+}
+
+TYPED_TEST(DoubleEndedLinearAllocatorTypedTest, ResetsEndsIndependently) {
+  auto* front{this->alloc->allocate_front(100, 8)};
+  auto* back{this->alloc->allocate_back(100, 8)};
+  ASSERT_NE(front, nullptr);
+  ASSERT_NE(back, nullptr);
+
+  // the frame end is cleared, the persistent end survives
+  this->alloc->reset_front();
+  EXPECT_EQ(this->alloc->allocate_front(100, 8), front);
+  EXPECT_NE(this->alloc->allocate_back(100, 8), back);
+
+  this->alloc->reset_back();
+  EXPECT_EQ(this->alloc->allocate_back(100, 8), back);
+  EXPECT_EQ(this->alloc->get_used(), 100 + 104);  // back aligns down
+}
+
+TYPED_TEST(DoubleEndedLinearAllocatorTypedTest, ResizeLastFrontStopsAtBack) {
+  auto* ptr{this->alloc->allocate_front(100, 8)};
+  ASSERT_NE(ptr, nullptr);
+  ASSERT_NE(this->alloc->allocate_back(500, 8), nullptr);
+
+  EXPECT_EQ(this->alloc->resize_last_front(ptr, 400, 8), ptr);
+  EXPECT_EQ(this->alloc->resize_last_front(ptr, 600, 8), nullptr);
+  EXPECT_EQ(this->alloc->resize_last_front(ptr + 8, 10, 8), nullptr);
+}
+
+TYPED_TEST(DoubleEndedLinearAllocatorTypedTest,
+           InvalidAlignmentReturnsNullptr) {
+  EXPECT_EQ(this->alloc->allocate_front(100, 0), nullptr);
+  EXPECT_EQ(this->alloc->allocate_front(100, 3), nullptr);
+  EXPECT_EQ(this->alloc->allocate_back(100, 0), nullptr);
+  EXPECT_EQ(this->alloc->allocate_back(100, 6), nullptr);
+}
+
+TYPED_TEST(DoubleEndedLinearAllocatorTypedTest, TypedHelpersUseBothEnds) {
+  TrackedObj::destructor_calls = 0;
+
+  TrackedObj* frame{this->alloc->template emplace_front<TrackedObj>(1)};
+  TrackedObj* level{this->alloc->template emplace_back<TrackedObj>(2)};
+  int* values{this->alloc->template allocate_back<int>(10)};
+
+  ASSERT_NE(frame, nullptr);
+  ASSERT_NE(level, nullptr);
+  ASSERT_NE(values, nullptr);
+
+  EXPECT_EQ(frame->value, 1);
+  EXPECT_EQ(level->value, 2);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(values) % alignof(int), 0);
+
+  this->alloc->destroy(frame);
+  this->alloc->destroy(level);
+  EXPECT_EQ(TrackedObj::destructor_calls, 2);
+}
+
+TYPED_TEST(DoubleEndedLinearAllocatorTypedTest, GetStateReportsBothEnds) {
+  ASSERT_NE(this->alloc->allocate_front(100, 8), nullptr);
+  ASSERT_NE(this->alloc->allocate_front(50, 8), nullptr);
+  ASSERT_NE(this->alloc->allocate_back(64, 8), nullptr);
+
+  std::string state{this->alloc->get_state()};
+  EXPECT_NE(state.find("\"used\":218"), std::string::npos);  // 104 + 50 + 64
+  EXPECT_EQ(count_occurrences(state, "\"status\":\"free\""), 1);
+
+  size_t expected{TypeParam::tracking == Tracking::DEBUG ? size_t{3} : 2};
+  EXPECT_EQ(count_occurrences(state, "\"status\":\"used\""), expected);
+}
+
+}  // namespace allocator::tests
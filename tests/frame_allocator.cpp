@@ -0,0 +1,162 @@
+#include "frame_allocator.h"
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <span>
+#include <type_traits>
+
+#include "growable_linear_allocator.h"
+#include "linear_allocator.h"
+
+namespace allocator::tests {
+template <typename Allocator>
+class FrameAllocatorTypedTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    if constexpr (Allocator::external_arena) {
+      alloc = std::make_unique<Allocator>(std::span{buf});
+    } else if constexpr (std::is_constructible_v<Allocator, size_t>) {
+      alloc = std::make_unique<Allocator>(size_t{1024});
+    } else {
+      alloc = std::make_unique<Allocator>();
+    }
+  }
+
+  std::unique_ptr<Allocator> alloc{};
+
+  // for arenas over buffertype::external, split between the frames
+  alignas(std::max_align_t) std::array<std::byte, 4096> buf{};
+};
+
+using AllocatorTypes = ::testing::Types<
+    FrameAllocator<LinearAllocator<1024>>,                        // double
+    FrameAllocator<LinearAllocator<1024, BufferType::STACK>, 3>,  // triple
+    FrameAllocator<LinearAllocator<dynamic_extent>, 4>,           // runtime
+    FrameAllocator<GrowableLinearAllocator<>, 2>,                 // growable
+    FrameAllocator<LinearAllocator<dynamic_extent, BufferType::EXTERNAL>,
+                   3>>;                                           // external
+
+TYPED_TEST_SUITE(FrameAllocatorTypedTest, AllocatorTypes);
+
+TYPED_TEST(FrameAllocatorTypedTest, DataOutlivesFrameForNMinusOneFrames) {
+  constexpr size_t n{TypeParam::frame_count};
+
+  int* produced{this->alloc->template allocate<int>(16)};
+  ASSERT_NE(produced, nullptr);
+  for (int i{}; i < 16; ++i) {
+    produced[i] = i;
+  }
+
+  // later frames fill their own arenas without touching it
+  for (size_t frame{1}; frame < n; ++frame) {
+    this->alloc->next_frame();
+    int* other{this->alloc->template allocate<int>(16)};
+    ASSERT_NE(other, nullptr);
+    std::memset(other, 0xff, 16 * sizeof(int));
+  }
+
+  for (int i{}; i < 16; ++i) {
+    EXPECT_EQ(produced[i], i);
+  }
+  EXPECT_EQ(&this->alloc->get_arena(n - 1), &this->alloc->get_arena(n * 2 - 1));
+}
+
+TYPED_TEST(FrameAllocatorTypedTest, NextFrameResetsOnlyOldestArena) {
+  constexpr size_t n{TypeParam::frame_count};
+
+  std::byte* first{this->alloc->allocate(100, 8)};
+  ASSERT_NE(first, nullptr);
+
+  for (size_t frame{1}; frame < n; ++frame) {
+    this->alloc->next_frame();
+    ASSERT_NE(this->alloc->allocate(100, 8), nullptr);
+  }
+
+  // wraps around to the first arena, which starts empty again
+  this->alloc->next_frame();
+  EXPECT_EQ(this->alloc->get_frame(), n);
+  EXPECT_EQ(this->alloc->allocate(100, 8), first);
+}
+
+TYPED_TEST(FrameAllocatorTypedTest, FramesUseSeparateArenas) {
+  std::byte* ptr1{this->alloc->allocate(100, 8)};
+  this->alloc->next_frame();
+  std::byte* ptr2{this->alloc->allocate(100, 8)};
+
+  ASSERT_NE(ptr1, nullptr);
+  ASSERT_NE(ptr2, nullptr);
+  EXPECT_NE(ptr1, ptr2);
+  EXPECT_NE(&this->alloc->get_arena(), &this->alloc->get_arena(1));
+}
+
+TYPED_TEST(FrameAllocatorTypedTest, ResetRestartsAtFirstArena) {
+  std::byte* first{this->alloc->allocate(100, 8)};
+  ASSERT_NE(first, nullptr);
+  this->alloc->next_frame();
+  ASSERT_NE(this->alloc->allocate(100, 8), nullptr);
+
+  this->alloc->reset();
+  EXPECT_EQ(this->alloc->get_frame(), 0);
+  EXPECT_EQ(this->alloc->allocate(100, 8), first);
+}
+
+TYPED_TEST(FrameAllocatorTypedTest, EmplaceConstructsInCurrentFrame) {
+  TrackedObj::destructor_calls = 0;
+
+  TrackedObj* obj{this->alloc->template emplace<TrackedObj>(7)};
+  ASSERT_NE(obj, nullptr);
+  EXPECT_EQ(obj->value, 7);
+
+  this->alloc->destroy(obj);
+  EXPECT_EQ(TrackedObj::destructor_calls, 1);
+}
+
+TEST(FrameAllocatorUpstreamTest, ArenasShareOneUpstream) {
+  LinearAllocator<dynamic_extent> upstream{4096};
+  FrameAllocator<GrowableLinearAllocator<LinearAllocator<dynamic_extent>>>
+      alloc{upstream, size_t{256}};
+
+  int* previous{alloc.allocate<int>()};
+  ASSERT_NE(previous, nullptr);
+  *previous = 42;
+
+  alloc.next_frame();
+  int* current{alloc.allocate<int>()};
+  ASSERT_NE(current, nullptr);
+  *current = 7;
+
+  // both frames carved their chunks from the one upstream
+  EXPECT_NE(previous, current);
+  EXPECT_EQ(*previous, 42);
+  EXPECT_LT(std::abs(reinterpret_cast<std::byte*>(current) -
+                     reinterpret_cast<std::byte*>(previous)),
+            4096);
+}
+
+TEST(FrameAllocatorExternalTest, FramesSplitTheBuffer) {
+  alignas(std::max_align_t) std::array<std::byte, 256> buf{};
+  FrameAllocator<LinearAllocator<dynamic_extent, BufferType::EXTERNAL>> alloc{
+      std::span{buf}};
+
+  int* previous{alloc.allocate<int>()};
+  ASSERT_NE(previous, nullptr);
+  *previous = 42;
+
+  // the next frame has its own half of the buffer
+  alloc.next_frame();
+  int* current{alloc.allocate<int>()};
+  ASSERT_NE(current, nullptr);
+  *current = 7;
+
+  EXPECT_EQ(*previous, 42);
+  EXPECT_EQ(reinterpret_cast<std::byte*>(current) -
+                reinterpret_cast<std::byte*>(previous),
+            128);
+  EXPECT_EQ(alloc.allocate(128, 1), nullptr);
+}
+
+}  // namespace allocator::tests
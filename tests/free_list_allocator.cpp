@@ -2,18 +2,26 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <atomic>
 #include <memory>
+#include <mutex>
+#include <queue>
+#include <random>
 #include <span>
+#include <thread>
+#include <utility>
+#include <vector>
 
 namespace allocator::tests {
 template <typename Allocator>
 class FreeListAllocatorTypedTest : public ::testing::Test {
  protected:
   void SetUp() override {
-    if constexpr (std::is_same_v<Allocator,
-                                 FreeListAllocator<1024, BufferType::EXTERNAL,
-                                                   FitStrategy::FIRST>>) {
+    if constexpr (Allocator::buffer_type == BufferType::EXTERNAL) {
       alloc = std::make_unique<Allocator>(buf);
+    } else if constexpr (Allocator::extent == dynamic_extent) {
+      alloc = std::make_unique<Allocator>(buf_size);
     } else {
       alloc = std::make_unique<Allocator>();
     }
@@ -31,7 +39,15 @@ using AllocatorTypes = ::testing::Types<
     FreeListAllocator<1024>,
     FreeListAllocator<1024, BufferType::HEAP, FitStrategy::BEST>,
     FreeListAllocator<1024, BufferType::STACK>,
-    FreeListAllocator<1024, BufferType::EXTERNAL>>;
+    FreeListAllocator<1024, BufferType::EXTERNAL>,
+    FreeListAllocator<1024, BufferType::HEAP, FitStrategy::FIRST,
+                      Tracking::DEBUG>,
+    FreeListAllocator<1024, BufferType::MMAP>,
+    FreeListAllocator<1024, BufferType::HEAP, FitStrategy::FIRST,
+                      Tracking::NONE, Concurrency::OWNER>,
+    FreeListAllocator<dynamic_extent>,
+    FreeListAllocator<dynamic_extent, BufferType::EXTERNAL, FitStrategy::BEST>,
+    FreeListAllocator<dynamic_extent, BufferType::MMAP, FitStrategy::BEST>>;
 
 TYPED_TEST_SUITE(FreeListAllocatorTypedTest, AllocatorTypes);
 
@@ -132,6 +148,33 @@ TYPED_TEST(FreeListAllocatorTypedTest, DeallocateOutOfBoundsPointer) {
   EXPECT_DEATH(this->alloc->deallocate(invalid), "pointer is out of bounds");
 }
 
+TYPED_TEST(FreeListAllocatorTypedTest, SizedDeallocateCoalesces) {
+  auto* ptr1{this->alloc->allocate(200, 8)};
+  auto* ptr2{this->alloc->allocate(200, 64)};
+  auto* ptr3{this->alloc->allocate(200, 4)};
+
+  ASSERT_NE(ptr1, nullptr);
+  ASSERT_NE(ptr2, nullptr);
+  ASSERT_NE(ptr3, nullptr);
+
+  // the over-aligned block still reads its padding word
+  this->alloc->deallocate(ptr3, 200, 4);
+  this->alloc->deallocate(ptr1, 200, 8);
+  this->alloc->deallocate(ptr2, 200, 64);
+  EXPECT_EQ(this->alloc->get_used(), 0);
+
+  auto* large{this->alloc->allocate(850, 8)};
+  EXPECT_NE(large, nullptr);
+}
+
+TYPED_TEST(FreeListAllocatorTypedTest, SizedDeallocateChecksSize) {
+  auto* ptr{this->alloc->allocate(100, 8)};
+  ASSERT_NE(ptr, nullptr);
+
+  EXPECT_DEATH(this->alloc->deallocate(ptr, 600, 8),
+               "size does not match the allocation");
+}
+
 TYPED_TEST(FreeListAllocatorTypedTest, FragmentationAndCoalescing) {
   auto* ptr1{this->alloc->allocate(300, 8)};
   auto* ptr2{this->alloc->allocate(300, 8)};
@@ -149,6 +192,197 @@ TYPED_TEST(FreeListAllocatorTypedTest, FragmentationAndCoalescing) {
   EXPECT_NE(large, nullptr);
 }
 
+TYPED_TEST(FreeListAllocatorTypedTest, CoalescesWithBothNeighbours) {
+  auto* ptr1{this->alloc->allocate(200, 8)};
+  auto* ptr2{this->alloc->allocate(200, 8)};
+  auto* ptr3{this->alloc->allocate(200, 8)};
+
+  ASSERT_NE(ptr1, nullptr);
+  ASSERT_NE(ptr2, nullptr);
+  ASSERT_NE(ptr3, nullptr);
+
+  // middle block freed last merges with free blocks on either side
+  this->alloc->deallocate(ptr3);
+  this->alloc->deallocate(ptr1);
+  this->alloc->deallocate(ptr2);
+
+  auto* merged{this->alloc->allocate(600, 8)};
+  EXPECT_EQ(merged, ptr1);
+}
+
+TYPED_TEST(FreeListAllocatorTypedTest, BestFitPicksSmallestBlock) {
+  if constexpr (TypeParam::fit_strategy != FitStrategy::BEST) {
+    GTEST_SKIP() << "first fit takes the first block that fits";
+  }
+
+  auto* large{this->alloc->allocate(200, 8)};
+  auto* guard1{this->alloc->allocate(8, 8)};
+  auto* small{this->alloc->allocate(64, 8)};
+  auto* guard2{this->alloc->allocate(8, 8)};
+
+  ASSERT_NE(large, nullptr);
+  ASSERT_NE(guard1, nullptr);
+  ASSERT_NE(small, nullptr);
+  ASSERT_NE(guard2, nullptr);
+
+  this->alloc->deallocate(small);
+  this->alloc->deallocate(large);
+
+  EXPECT_EQ(this->alloc->allocate(64, 8), small);
+  EXPECT_EQ(this->alloc->allocate(200, 8), large);
+}
+
+TYPED_TEST(FreeListAllocatorTypedTest, RandomChurnKeepsBlocksIntact) {
+  std::mt19937 rng{42};
+  std::vector<std::pair<std::byte*, size_t>> live{};
+
+  for (int i{}; i < 5000; ++i) {
+    if (live.empty() || rng() % 2 == 0) {
+      size_t size{8 + rng() % 96};
+      size_t alignment{size_t{8} << (rng() % 3)};
+      std::byte* ptr{this->alloc->allocate(size, alignment)};
+      if (ptr) {
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(ptr) % alignment, 0);
+        std::fill_n(ptr, size, static_cast<std::byte>(size));
+        live.emplace_back(ptr, size);
+      }
+    } else {
+      size_t index{rng() % live.size()};
+      auto [ptr, size] = live[index];
+      for (size_t j{}; j < size; ++j) {
+        ASSERT_EQ(ptr[j], static_cast<std::byte>(size));
+      }
+
+      this->alloc->deallocate(ptr);
+      live[index] = live.back();
+      live.pop_back();
+    }
+  }
+
+  for (auto [ptr, size] : live) {
+    this->alloc->deallocate(ptr);
+  }
+
+  EXPECT_EQ(this->alloc->get_used(), 0);
+  EXPECT_NE(this->alloc->allocate(900, 8), nullptr);
+}
+
+TYPED_TEST(FreeListAllocatorTypedTest, ReallocateGrowsIntoFreeNeighbour) {
+  auto* ptr1{this->alloc->allocate(64, 8)};
+  auto* ptr2{this->alloc->allocate(64, 8)};
+  auto* ptr3{this->alloc->allocate(64, 8)};
+  ASSERT_NE(ptr3, nullptr);
+  std::fill_n(ptr1, 64, std::byte{0x5a});
+  std::fill_n(ptr3, 64, std::byte{0x3c});
+  this->alloc->deallocate(ptr2);
+  size_t used{this->alloc->get_used()};
+
+  auto* grown{this->alloc->reallocate(ptr1, 120, 8)};
+  EXPECT_EQ(grown, ptr1);
+  EXPECT_GT(this->alloc->get_used(), used);
+  EXPECT_TRUE(std::all_of(grown, grown + 64,
+                          [](std::byte b) { return b == std::byte{0x5a}; }));
+  EXPECT_TRUE(std::all_of(ptr3, ptr3 + 64,
+                          [](std::byte b) { return b == std::byte{0x3c}; }));
+
+  this->alloc->deallocate(grown);
+  this->alloc->deallocate(ptr3);
+  EXPECT_EQ(this->alloc->get_used(), 0);
+}
+
+TYPED_TEST(FreeListAllocatorTypedTest, ReallocateShrinksInPlace) {
+  auto* ptr1{this->alloc->allocate(512, 8)};
+  auto* ptr2{this->alloc->allocate(64, 8)};
+  ASSERT_NE(ptr2, nullptr);
+  size_t used{this->alloc->get_used()};
+
+  // the freed tail sits between two allocated blocks, and is the only
+  // free block large enough for the next allocation
+  auto* shrunk{this->alloc->reallocate(ptr1, 64, 8)};
+  EXPECT_EQ(shrunk, ptr1);
+  EXPECT_LT(this->alloc->get_used(), used);
+
+  auto* ptr3{this->alloc->allocate(420, 8)};
+  ASSERT_NE(ptr3, nullptr);
+  EXPECT_GT(ptr3, shrunk);
+  EXPECT_LT(ptr3, ptr2);
+
+  this->alloc->deallocate(shrunk);
+  this->alloc->deallocate(ptr2);
+  this->alloc->deallocate(ptr3);
+  EXPECT_EQ(this->alloc->get_used(), 0);
+  EXPECT_NE(this->alloc->allocate(900, 8), nullptr);
+}
+
+TYPED_TEST(FreeListAllocatorTypedTest, ReallocateMovesWhenNeighbourIsTaken) {
+  auto* ptr1{this->alloc->allocate(64, 8)};
+  auto* ptr2{this->alloc->allocate(64, 8)};
+  ASSERT_NE(ptr2, nullptr);
+  std::fill_n(ptr1, 64, std::byte{0x5a});
+
+  auto* moved{this->alloc->reallocate(ptr1, 256, 8)};
+  ASSERT_NE(moved, nullptr);
+  EXPECT_NE(moved, ptr1);
+  EXPECT_TRUE(std::all_of(moved, moved + 64,
+                          [](std::byte b) { return b == std::byte{0x5a}; }));
+
+  // and nothing moves when there is no room anywhere
+  EXPECT_EQ(this->alloc->reallocate(moved, 2000, 8), nullptr);
+
+  this->alloc->deallocate(moved);
+  this->alloc->deallocate(ptr2);
+  EXPECT_EQ(this->alloc->get_used(), 0);
+}
+
+TYPED_TEST(FreeListAllocatorTypedTest, ReallocateNullptrAllocates) {
+  auto* ptr{this->alloc->reallocate(nullptr, 64, 16)};
+  ASSERT_NE(ptr, nullptr);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(ptr) % 16, 0);
+  EXPECT_EQ(this->alloc->reallocate(ptr, 64, 3), nullptr);
+}
+
+TYPED_TEST(FreeListAllocatorTypedTest, AllocateBulkCarvesDistinctBlocks) {
+  std::array<std::byte*, 16> blocks{};
+  ASSERT_EQ(this->alloc->allocate_bulk(16, 24, 16, blocks), 16);
+
+  // writing every block in full leaves the others intact
+  for (size_t i{}; i < blocks.size(); ++i) {
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(blocks[i]) % 16, 0);
+    std::fill_n(blocks[i], 24, static_cast<std::byte>(i));
+  }
+  for (size_t i{}; i < blocks.size(); ++i) {
+    EXPECT_TRUE(std::all_of(blocks[i], blocks[i] + 24, [i](std::byte b) {
+      return b == static_cast<std::byte>(i);
+    }));
+  }
+
+  this->alloc->deallocate_bulk(blocks);
+  EXPECT_EQ(this->alloc->get_used(), 0);
+  EXPECT_NE(this->alloc->allocate(900, 8), nullptr);
+}
+
+TYPED_TEST(FreeListAllocatorTypedTest, AllocateBulkFillsEveryFreeBlock) {
+  auto* ptr1{this->alloc->allocate(200, 8)};
+  auto* ptr2{this->alloc->allocate(200, 8)};
+  auto* ptr3{this->alloc->allocate(200, 8)};
+  ASSERT_NE(ptr3, nullptr);
+  this->alloc->deallocate(ptr1);
+
+  // carves the freed hole and the tail, until neither has room
+  std::array<std::byte*, 64> blocks{};
+  size_t count{this->alloc->allocate_bulk(64, 32, 8, blocks)};
+  EXPECT_GT(count, 0);
+  EXPECT_LT(count, 64);
+  EXPECT_EQ(this->alloc->allocate(32, 8), nullptr);
+  EXPECT_TRUE(std::ranges::any_of(std::span{blocks}.first(count),
+                                  [ptr2](std::byte* b) { return b < ptr2; }));
+
+  this->alloc->deallocate_bulk(std::span{blocks}.first(count));
+  this->alloc->deallocate(ptr2);
+  this->alloc->deallocate(ptr3);
+  EXPECT_EQ(this->alloc->get_used(), 0);
+}
+
 TYPED_TEST(FreeListAllocatorTypedTest, ResetsSuccessfully) {
   auto* ptr1{this->alloc->allocate(500, 8)};
   ASSERT_NE(ptr1, nullptr);
@@ -223,4 +457,110 @@ TYPED_TEST(FreeListAllocatorTypedTest, DestroyCallsDestructor) {
   EXPECT_EQ(TrackedObj::destructor_calls, 3);
 }
 
-}  // namespace allocator::tests
\ No newline at end of file
+
+TYPED_TEST(FreeListAllocatorTypedTest, GetStateReportsBlocks) {
+  auto* ptr1{this->alloc->allocate(100, 8)};
+  auto* ptr2{this->alloc->allocate(100, 8)};
+  auto* ptr3{this->alloc->allocate(100, 8)};
+
+  ASSERT_NE(ptr1, nullptr);
+  ASSERT_NE(ptr2, nullptr);
+  ASSERT_NE(ptr3, nullptr);
+
+  this->alloc->deallocate(ptr2);
+
+  // identical view whether tracked or rebuilt from the buffer
+  std::string state{this->alloc->get_state()};
+  EXPECT_EQ(count_occurrences(state, "\"status\":\"used\""), 2);
+  EXPECT_EQ(count_occurrences(state, "\"status\":\"free\""), 2);
+  EXPECT_NE(state.find("\"used\":" + std::to_string(this->alloc->get_used())),
+            std::string::npos);
+}
+
+TYPED_TEST(FreeListAllocatorTypedTest, RemoteFreesReturnOnNextAllocation) {
+  if constexpr (TypeParam::concurrency != Concurrency::OWNER) {
+    GTEST_SKIP() << "only the owner may deallocate";
+  } else {
+    auto* ptr1{this->alloc->allocate(100, 8)};
+    auto* ptr2{this->alloc->allocate(100, 8)};
+    ASSERT_NE(ptr1, nullptr);
+    ASSERT_NE(ptr2, nullptr);
+    size_t used{this->alloc->get_used()};
+
+    std::thread worker{[&] {
+      this->alloc->deallocate(ptr1);
+      this->alloc->deallocate(ptr2);
+    }};
+    worker.join();
+
+    // queued until the owner allocates again, then coalesced back
+    EXPECT_EQ(this->alloc->get_used(), used);
+    auto* ptr3{this->alloc->allocate(200, 8)};
+    EXPECT_EQ(ptr3, ptr1);
+    EXPECT_LT(this->alloc->get_used(), used);
+
+    this->alloc->deallocate(ptr3);
+    EXPECT_EQ(this->alloc->get_used(), 0);
+  }
+}
+
+TEST(FreeListAllocatorTest, ProducerConsumerFreesAcrossThreads) {
+  constexpr size_t total{20000};
+  FreeListAllocator<4096, BufferType::HEAP, FitStrategy::FIRST,
+                    Tracking::NONE, Concurrency::OWNER>
+      alloc{};
+
+  std::mutex mutex{};
+  std::queue<std::pair<std::byte*, size_t>> queue{};
+  std::atomic<bool> done{false};
+
+  // frees every block on a thread that never allocates
+  std::thread consumer{[&] {
+    while (true) {
+      std::pair<std::byte*, size_t> block{};
+      {
+        std::lock_guard lock{mutex};
+        if (!queue.empty()) {
+          block = queue.front();
+          queue.pop();
+        } else if (done.load()) {
+          return;
+        }
+      }
+      if (!block.first) {
+        std::this_thread::yield();
+        continue;
+      }
+
+      auto tag{static_cast<std::byte>(block.second)};
+      ASSERT_EQ(std::count(block.first, block.first + block.second, tag),
+                static_cast<std::ptrdiff_t>(block.second));
+      alloc.deallocate(block.first);
+    }
+  }};
+
+  std::mt19937 rng{7};
+  std::uniform_int_distribution<size_t> size_dist{1, 200};
+  for (size_t produced{}; produced < total;) {
+    size_t size{size_dist(rng)};
+    std::byte* ptr{alloc.allocate(size, 8)};
+    if (!ptr) {
+      std::this_thread::yield();  // full until the consumer catches up
+      continue;
+    }
+
+    std::fill_n(ptr, size, static_cast<std::byte>(size));
+    std::lock_guard lock{mutex};
+    queue.emplace(ptr, size);
+    ++produced;
+  }
+
+  done.store(true);
+  consumer.join();
+
+  // the last frees are still queued, the next allocation takes them back
+  auto* whole{alloc.allocate(4096 - 64, 8)};
+  EXPECT_NE(whole, nullptr);
+}
+
+}  // namespace allocator::tests
@@ -0,0 +1,232 @@
+#include "growable_linear_allocator.h"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <type_traits>
+
+#include "buddy_allocator.h"
+#include "free_list_allocator.h"
+
+namespace allocator::tests {
+template <typename Allocator>
+class GrowableLinearAllocatorTypedTest : public ::testing::Test {
+ protected:
+  using Upstream = typename Allocator::upstream_type;
+
+  void SetUp() override {
+    if constexpr (std::is_same_v<Upstream, HeapUpstream>) {
+      alloc = std::make_unique<Allocator>(chunk_size);
+    } else {
+      upstream = std::make_unique<Upstream>();
+      alloc = std::make_unique<Allocator>(*upstream, chunk_size);
+    }
+  }
+
+  static constexpr size_t chunk_size{256};
+
+  std::unique_ptr<Upstream> upstream{};
+  std::unique_ptr<Allocator> alloc{};
+};
+
+using AllocatorTypes = ::testing::Types<
+    GrowableLinearAllocator<>,                                     // heap
+    GrowableLinearAllocator<HeapUpstream, Retention::HIGH_WATER>,  // peak
+    GrowableLinearAllocator<FreeListAllocator<65536>>,             // free list
+    GrowableLinearAllocator<BuddyAllocator<65536>, Retention::HIGH_WATER>>;
+
+TYPED_TEST_SUITE(GrowableLinearAllocatorTypedTest, AllocatorTypes);
+
+TYPED_TEST(GrowableLinearAllocatorTypedTest, GrowsPastFirstChunk) {
+  std::byte* pointers[64]{};
+  for (size_t i{}; i < 64; ++i) {
+    pointers[i] = this->alloc->allocate(64, 8);
+    ASSERT_NE(pointers[i], nullptr);
+    std::fill_n(pointers[i], 64, std::byte{static_cast<unsigned char>(i)});
+  }
+
+  // no allocation overlaps another
+  for (size_t i{}; i < 64; ++i) {
+    EXPECT_EQ(pointers[i][0], std::byte{static_cast<unsigned char>(i)});
+    EXPECT_EQ(pointers[i][63], std::byte{static_cast<unsigned char>(i)});
+  }
+
+  EXPECT_EQ(this->alloc->get_used(), 64 * 64);
+  EXPECT_GE(this->alloc->get_capacity(), 64 * 64);
+}
+
+TYPED_TEST(GrowableLinearAllocatorTypedTest, AlignsCorrectly) {
+  auto* ptr1{this->alloc->allocate(13, 1)};
+  auto* ptr2{this->alloc->allocate(50, 8)};
+  auto* ptr3{this->alloc->allocate(100, 64)};
+  auto* ptr4{this->alloc->allocate(100, 1024)};
+
+  ASSERT_NE(ptr1, nullptr);
+  ASSERT_NE(ptr2, nullptr);
+  ASSERT_NE(ptr3, nullptr);
+  ASSERT_NE(ptr4, nullptr);
+
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(ptr2) % 8, 0);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(ptr3) % 64, 0);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(ptr4) % 1024, 0);
+}
+
+TYPED_TEST(GrowableLinearAllocatorTypedTest, LargeRequestGetsOwnChunk) {
+  auto* small{this->alloc->allocate(16, 8)};
+  auto* large{this->alloc->allocate(4096, 8)};
+
+  ASSERT_NE(small, nullptr);
+  ASSERT_NE(large, nullptr);
+  std::fill_n(large, 4096, std::byte{1});
+
+  // the first chunk still has room for later small requests
+  auto* after{this->alloc->allocate(16, 8)};
+  ASSERT_NE(after, nullptr);
+  EXPECT_EQ(after, small + 16);
+}
+
+TYPED_TEST(GrowableLinearAllocatorTypedTest, ResetKeepsLargestChunk) {
+  for (size_t i{}; i < 64; ++i) {
+    ASSERT_NE(this->alloc->allocate(64, 8), nullptr);
+  }
+  size_t grown{this->alloc->get_capacity()};
+
+  this->alloc->reset();
+  EXPECT_EQ(this->alloc->get_used(), 0);
+
+  if constexpr (TypeParam::retention == Retention::LARGEST) {
+    EXPECT_LT(this->alloc->get_capacity(), grown);
+  } else {
+    EXPECT_EQ(this->alloc->get_capacity(), grown);
+  }
+
+  // the retained memory is reused without growing
+  size_t retained{this->alloc->get_capacity()};
+  auto* ptr{this->alloc->allocate(retained / 2, 8)};
+  ASSERT_NE(ptr, nullptr);
+  EXPECT_EQ(this->alloc->get_capacity(), retained);
+}
+
+TYPED_TEST(GrowableLinearAllocatorTypedTest, ResetReusesSameMemory) {
+  auto* ptr1{this->alloc->allocate(100, 8)};
+  ASSERT_NE(ptr1, nullptr);
+
+  this->alloc->reset();
+
+  auto* ptr2{this->alloc->allocate(100, 8)};
+  EXPECT_EQ(ptr1, ptr2);
+}
+
+TYPED_TEST(GrowableLinearAllocatorTypedTest, HighWaterReleasesUnusedChunks) {
+  for (size_t i{}; i < 64; ++i) {
+    ASSERT_NE(this->alloc->allocate(64, 8), nullptr);
+  }
+  this->alloc->reset();
+  size_t peak{this->alloc->get_capacity()};
+
+  // a quieter cycle leaves later chunks untouched
+  ASSERT_NE(this->alloc->allocate(64, 8), nullptr);
+  this->alloc->reset();
+
+  if constexpr (TypeParam::retention == Retention::HIGH_WATER) {
+    EXPECT_LT(this->alloc->get_capacity(), peak);
+  } else {
+    EXPECT_EQ(this->alloc->get_capacity(), peak);
+  }
+  EXPECT_NE(this->alloc->allocate(64, 8), nullptr);
+}
+
+TYPED_TEST(GrowableLinearAllocatorTypedTest, ResizeLastGrowsWithinChunk) {
+  auto* ptr{this->alloc->allocate(50, 8)};
+  ASSERT_NE(ptr, nullptr);
+
+  EXPECT_EQ(this->alloc->resize_last(ptr, 100, 8), ptr);
+  EXPECT_EQ(this->alloc->get_used(), 100);
+
+  // past the end of the chunk, the caller allocates anew
+  EXPECT_EQ(this->alloc->resize_last(ptr, 4096, 8), nullptr);
+  EXPECT_EQ(this->alloc->resize_last(ptr + 8, 10, 8), nullptr);
+}
+
+TYPED_TEST(GrowableLinearAllocatorTypedTest, RewindReusesLaterChunks) {
+  ASSERT_NE(this->alloc->allocate(64, 8), nullptr);
+  auto marker{this->alloc->get_marker()};
+
+  std::byte* first{};
+  for (size_t i{}; i < 64; ++i) {
+    std::byte* ptr{this->alloc->allocate(64, 8)};
+    ASSERT_NE(ptr, nullptr);
+    first = first ? first : ptr;
+  }
+  size_t grown{this->alloc->get_capacity()};
+
+  this->alloc->rewind(marker);
+  EXPECT_EQ(this->alloc->get_used(), 64);
+
+  // the same allocations fit in the chunks already taken
+  EXPECT_EQ(this->alloc->allocate(64, 8), first);
+  for (size_t i{1}; i < 64; ++i) {
+    ASSERT_NE(this->alloc->allocate(64, 8), nullptr);
+  }
+  EXPECT_EQ(this->alloc->get_capacity(), grown);
+}
+
+TYPED_TEST(GrowableLinearAllocatorTypedTest, RewindReleasesOversizedChunks) {
+  ASSERT_NE(this->alloc->allocate(64, 8), nullptr);
+  size_t capacity{this->alloc->get_capacity()};
+
+  // repeated scopes with large requests don't accumulate chunks
+  for (size_t i{}; i < 8; ++i) {
+    auto marker{this->alloc->get_marker()};
+    ASSERT_NE(this->alloc->allocate(8192, 8), nullptr);
+    this->alloc->rewind(marker);
+    EXPECT_EQ(this->alloc->get_capacity(), capacity);
+  }
+}
+
+TYPED_TEST(GrowableLinearAllocatorTypedTest, InvalidAlignmentReturnsNullptr) {
+  EXPECT_EQ(this->alloc->allocate(100, 0), nullptr);
+  EXPECT_EQ(this->alloc->allocate(100, 3), nullptr);
+  EXPECT_EQ(this->alloc->allocate(100, 6), nullptr);
+}
+
+TYPED_TEST(GrowableLinearAllocatorTypedTest, EmplaceAndDestroy) {
+  TrackedObj::destructor_calls = 0;
+
+  TrackedObj* objects[32]{};
+  for (int i{}; i < 32; ++i) {
+    objects[i] = this->alloc->template emplace<TrackedObj>(i);
+    ASSERT_NE(objects[i], nullptr);
+  }
+
+  for (int i{}; i < 32; ++i) {
+    EXPECT_EQ(objects[i]->value, i);
+    this->alloc->destroy(objects[i]);
+  }
+  EXPECT_EQ(TrackedObj::destructor_calls, 32);
+}
+
+TEST(GrowableLinearAllocatorTest, ReturnsNullptrWhenUpstreamIsExhausted) {
+  FreeListAllocator<1024> upstream{};
+  GrowableLinearAllocator<FreeListAllocator<1024>> alloc{upstream, 256};
+
+  EXPECT_NE(alloc.allocate(128, 8), nullptr);
+  EXPECT_EQ(alloc.allocate(4096, 8), nullptr);
+
+  // the failed request leaves the current chunk usable
+  EXPECT_NE(alloc.allocate(64, 8), nullptr);
+}
+
+TEST(GrowableLinearAllocatorTest, ReturnsChunksToUpstream) {
+  FreeListAllocator<65536> upstream{};
+  {
+    GrowableLinearAllocator<FreeListAllocator<65536>> alloc{upstream, 256};
+    for (size_t i{}; i < 64; ++i) {
+      ASSERT_NE(alloc.allocate(64, 8), nullptr);
+    }
+    EXPECT_GT(upstream.get_used(), 0);
+  }
+  EXPECT_EQ(upstream.get_used(), 0);
+}
+
+}  // namespace allocator::tests
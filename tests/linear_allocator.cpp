@@ -10,9 +10,10 @@ template <typename Allocator>
 class LinearAllocatorTypedTest : public ::testing::Test {
  protected:
   void SetUp() override {
-    if constexpr (std::is_same_v<Allocator,
-                                 LinearAllocator<1024, BufferType::EXTERNAL>>) {
+    if constexpr (Allocator::buffer_type == BufferType::EXTERNAL) {
       alloc = std::make_unique<Allocator>(buf);
+    } else if constexpr (Allocator::extent == dynamic_extent) {
+      alloc = std::make_unique<Allocator>(buf_size);
     } else {
       alloc = std::make_unique<Allocator>();
     }
@@ -28,7 +29,13 @@ class LinearAllocatorTypedTest : public ::testing::Test {
 using AllocatorTypes =
     ::testing::Types<LinearAllocator<1024>,                         // heap
                      LinearAllocator<1024, BufferType::STACK>,      // stack
-                     LinearAllocator<1024, BufferType::EXTERNAL>>;  // external
+                     LinearAllocator<1024, BufferType::EXTERNAL>,   // external
+                     LinearAllocator<1024, BufferType::HEAP,
+                                     Tracking::DEBUG>,  // tracked
+                     LinearAllocator<1024, BufferType::MMAP>,  // mapped
+                     LinearAllocator<dynamic_extent>,          // runtime
+                     LinearAllocator<dynamic_extent, BufferType::EXTERNAL>,
+                     LinearAllocator<dynamic_extent, BufferType::MMAP>>;
 
 TYPED_TEST_SUITE(LinearAllocatorTypedTest, AllocatorTypes);
 
@@ -73,6 +80,36 @@ TYPED_TEST(LinearAllocatorTypedTest, ReturnsNullptrWhenOutOfMemory) {
   EXPECT_EQ(ptr, nullptr);
 }
 
+TYPED_TEST(LinearAllocatorTypedTest, AllocateBulkMatchesSingleAllocations) {
+  std::array<std::byte*, 4> blocks{};
+  ASSERT_EQ(this->alloc->allocate_bulk(4, 24, 16, blocks), 4);
+
+  // each a stride of the size rounded up to the alignment past the last
+  for (size_t i{}; i < blocks.size(); ++i) {
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(blocks[i]) % 16, 0);
+    if (i > 0) {
+      EXPECT_EQ(blocks[i] - blocks[i - 1], 32);
+    }
+  }
+
+  auto* next{this->alloc->allocate(8, 16)};
+  EXPECT_EQ(next, blocks.back() + 32);
+}
+
+TYPED_TEST(LinearAllocatorTypedTest, AllocateBulkStopsWhenFull) {
+  std::array<std::byte*, 32> blocks{};
+  size_t count{this->alloc->allocate_bulk(32, 100, 8, blocks)};
+
+  EXPECT_GE(count, 9);
+  EXPECT_LE(count, 10);
+  EXPECT_EQ(this->alloc->allocate(100, 8), nullptr);
+
+  // never more than out holds
+  this->alloc->reset();
+  EXPECT_EQ(this->alloc->allocate_bulk(8, 16, 8, std::span{blocks}.first(2)),
+            2);
+}
+
 TYPED_TEST(LinearAllocatorTypedTest, ResetsSuccessfully) {
   auto* ptr1{this->alloc->allocate(500, 8)};
   ASSERT_NE(ptr1, nullptr);
@@ -124,6 +161,36 @@ TYPED_TEST(LinearAllocatorTypedTest, ResizeLastReturnsNullptrOnOutOfBounds) {
   EXPECT_EQ(this->alloc->resize_last(invalid, 200, 8), nullptr);
 }
 
+TYPED_TEST(LinearAllocatorTypedTest, RewindReleasesAllocationsAfterMarker) {
+  auto* kept{this->alloc->allocate(100, 8)};
+  ASSERT_NE(kept, nullptr);
+
+  auto marker{this->alloc->get_marker()};
+  auto* released{this->alloc->allocate(200, 8)};
+  ASSERT_NE(released, nullptr);
+  ASSERT_NE(this->alloc->allocate(300, 8), nullptr);
+
+  this->alloc->rewind(marker);
+
+  // the next allocation reuses the released memory
+  EXPECT_EQ(this->alloc->allocate(200, 8), released);
+
+  std::string state{this->alloc->get_state()};
+  EXPECT_NE(state.find("\"used\":304"), std::string::npos);  // 104 + 200
+}
+
+TYPED_TEST(LinearAllocatorTypedTest, RewindRestoresResizeLast) {
+  auto* last{this->alloc->allocate(100, 8)};
+  ASSERT_NE(last, nullptr);
+
+  auto marker{this->alloc->get_marker()};
+  ASSERT_NE(this->alloc->allocate(100, 8), nullptr);
+  EXPECT_EQ(this->alloc->resize_last(last, 200, 8), nullptr);
+
+  this->alloc->rewind(marker);
+  EXPECT_EQ(this->alloc->resize_last(last, 200, 8), last);
+}
+
 TYPED_TEST(LinearAllocatorTypedTest, InvalidAlignmentReturnsNullptr) {
   EXPECT_EQ(this->alloc->allocate(100, 0), nullptr);
   EXPECT_EQ(this->alloc->allocate(100, 3), nullptr);
@@ -174,4 +241,19 @@ TYPED_TEST(LinearAllocatorTypedTest, DestroyCallsDestructor) {
   this->alloc->template destroy(obj3);
   EXPECT_EQ(TrackedObj::destructor_calls, 3);
 }
+
+TYPED_TEST(LinearAllocatorTypedTest, GetStateReportsUsedBytes) {
+  auto* ptr1{this->alloc->allocate(100, 8)};
+  auto* ptr2{this->alloc->allocate(50, 8)};
+
+  ASSERT_NE(ptr1, nullptr);
+  ASSERT_NE(ptr2, nullptr);
+
+  std::string state{this->alloc->get_state()};
+  EXPECT_NE(state.find("\"used\":154"), std::string::npos);  // 104 + 50
+
+  size_t expected{TypeParam::tracking == Tracking::DEBUG ? size_t{2} : 1};
+  EXPECT_EQ(count_occurrences(state, "\"status\":\"used\""), expected);
+}
+
 }  // namespace allocator::tests
\ No newline at end of file
@@ -0,0 +1,85 @@
+#include "memory_resource.h"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "buddy_allocator.h"
+#include "free_list_allocator.h"
+#include "linear_allocator.h"
+
+namespace allocator::tests {
+template <typename Allocator>
+class MemoryResourceTypedTest : public ::testing::Test {
+ protected:
+  std::unique_ptr<Allocator> alloc{std::make_unique<Allocator>()};
+  MemoryResource<Allocator> resource{*alloc};
+};
+
+using AllocatorTypes =
+    ::testing::Types<LinearAllocator<4096>, FreeListAllocator<4096>,
+                     BuddyAllocator<4096>>;
+
+TYPED_TEST_SUITE(MemoryResourceTypedTest, AllocatorTypes);
+
+TYPED_TEST(MemoryResourceTypedTest, BacksVector) {
+  std::pmr::vector<int> values{&this->resource};
+  for (int i{}; i < 100; ++i) {
+    values.push_back(i);
+  }
+
+  for (int i{}; i < 100; ++i) {
+    EXPECT_EQ(values[i], i);
+  }
+}
+
+TYPED_TEST(MemoryResourceTypedTest, BacksNestedContainers) {
+  std::pmr::unordered_map<int, std::pmr::string> names{&this->resource};
+  for (int i{}; i < 16; ++i) {
+    names.emplace(i, "a string long enough to need an allocation");
+  }
+
+  EXPECT_EQ(names.size(), 16);
+  EXPECT_EQ(names.at(3).get_allocator().resource(), &this->resource);
+}
+
+TYPED_TEST(MemoryResourceTypedTest, AlignsAllocations) {
+  void* ptr{this->resource.allocate(24, 64)};
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(ptr) % 64, 0);
+  this->resource.deallocate(ptr, 24, 64);
+}
+
+TYPED_TEST(MemoryResourceTypedTest, ThrowsWhenOutOfMemory) {
+  EXPECT_THROW((void)this->resource.allocate(8192, 8), std::bad_alloc);
+}
+
+TYPED_TEST(MemoryResourceTypedTest, ReclaimsDeallocatedMemory) {
+  void* ptr1{this->resource.allocate(64, 8)};
+  this->resource.deallocate(ptr1, 64, 8);
+
+  void* ptr2{this->resource.allocate(64, 8)};
+  if constexpr (requires(std::byte* p) { this->alloc->deallocate(p); }) {
+    EXPECT_EQ(ptr1, ptr2);
+  } else {
+    // linear allocator only reclaims on reset
+    EXPECT_NE(ptr1, ptr2);
+  }
+}
+
+TYPED_TEST(MemoryResourceTypedTest, EqualWhenSharingAllocator) {
+  MemoryResource<TypeParam> same{*this->alloc};
+  EXPECT_TRUE(this->resource.is_equal(same));
+
+  TypeParam other_alloc{};
+  MemoryResource<TypeParam> other{other_alloc};
+  EXPECT_FALSE(this->resource.is_equal(other));
+
+  EXPECT_FALSE(this->resource.is_equal(*std::pmr::new_delete_resource()));
+}
+
+}  // namespace allocator::tests
@@ -0,0 +1,63 @@
+#include "mmap_buffer.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+
+#include "buddy_allocator.h"
+#include "linear_allocator.h"
+
+namespace allocator::tests {
+TEST(MmapBufferTest, RoundsToPagesOrHugePages) {
+  EXPECT_EQ(mapped_length(1), page_size);
+  EXPECT_EQ(mapped_length(page_size + 1), 2 * page_size);
+  EXPECT_EQ(mapped_length(huge_page_size), huge_page_size);
+  EXPECT_EQ(mapped_length(huge_page_size + 1), 2 * huge_page_size);
+}
+
+TEST(MmapBufferTest, AlignsToHugePageSize) {
+  for (auto huge_pages :
+       {HugePages::NONE, HugePages::TRANSPARENT, HugePages::EXPLICIT}) {
+    std::byte* buffer{map_buffer(huge_page_size, {huge_pages, false})};
+    ASSERT_NE(buffer, nullptr);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(buffer) % huge_page_size, 0);
+
+    // writable through to the last byte
+    std::fill_n(buffer, huge_page_size, std::byte{1});
+    EXPECT_EQ(buffer[huge_page_size - 1], std::byte{1});
+    unmap_buffer(buffer, huge_page_size);
+  }
+}
+
+TEST(MmapBufferTest, PopulatedBufferIsZeroed) {
+  std::byte* buffer{map_buffer(64 * page_size, {HugePages::NONE, true})};
+  ASSERT_NE(buffer, nullptr);
+  EXPECT_TRUE(std::all_of(buffer, buffer + 64 * page_size,
+                          [](std::byte b) { return b == std::byte{0}; }));
+  unmap_buffer(buffer, 64 * page_size);
+}
+
+TEST(MmapBufferTest, ExplicitFallsBackWhenSmallerThanHugePage) {
+  // never eligible for hugetlbfs, so always takes the fallback
+  std::byte* buffer{map_buffer(page_size, {HugePages::EXPLICIT, true})};
+  ASSERT_NE(buffer, nullptr);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(buffer) % huge_page_size, 0);
+  unmap_buffer(buffer, page_size);
+}
+
+TEST(MmapBufferTest, AllocatorsTakeMapOptions) {
+  LinearAllocator<huge_page_size, BufferType::MMAP> linear{
+      MapOptions{HugePages::TRANSPARENT, true}};
+  BuddyAllocator<dynamic_extent, BufferType::MMAP> buddy{
+      3 * huge_page_size, MapOptions{HugePages::EXPLICIT, false}};
+
+  auto* ptr1{linear.allocate(huge_page_size, 4096)};
+  ASSERT_NE(ptr1, nullptr);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(ptr1) % huge_page_size, 0);
+
+  // the buddy capacity is rounded down to a power of two
+  auto* ptr2{buddy.allocate(huge_page_size, 8)};
+  ASSERT_NE(ptr2, nullptr);
+  EXPECT_EQ(buddy.allocate(2 * huge_page_size, 8), nullptr);
+}
+}  // namespace allocator::tests
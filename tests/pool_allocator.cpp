@@ -0,0 +1,280 @@
+#include "pool_allocator.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <set>
+#include <thread>
+#include <vector>
+
+namespace allocator::tests {
+template <typename Allocator>
+class PoolAllocatorTypedTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    if constexpr (Allocator::buffer_type == BufferType::EXTERNAL) {
+      alloc = std::make_unique<Allocator>(buf);
+    } else if constexpr (Allocator::S == dynamic_extent) {
+      alloc = std::make_unique<Allocator>(block_count);
+    } else {
+      alloc = std::make_unique<Allocator>();
+    }
+  }
+
+  std::unique_ptr<Allocator> alloc{};
+
+  static constexpr size_t block_size{32};
+  static constexpr size_t block_count{32};
+
+  // for buffertype::external allocator
+  alignas(std::max_align_t)
+      std::array<std::byte, block_size * block_count> buf{};
+};
+
+using AllocatorTypes =
+    ::testing::Types<PoolAllocator<32, 32>,                         // heap
+                     PoolAllocator<32, 32, BufferType::STACK>,      // stack
+                     PoolAllocator<32, 32, BufferType::EXTERNAL>,   // external
+                     PoolAllocator<32, 32, BufferType::MMAP>,       // mapped
+                     PoolAllocator<32, 32, BufferType::HEAP,
+                                   Concurrency::OWNER>,     // remote frees
+                     PoolAllocator<32, dynamic_extent>,             // runtime
+                     PoolAllocator<32, dynamic_extent,
+                                   BufferType::EXTERNAL>,  // runtime external
+                     PoolAllocator<32, dynamic_extent,
+                                   BufferType::MMAP>>;  // runtime mapped
+
+TYPED_TEST_SUITE(PoolAllocatorTypedTest, AllocatorTypes);
+
+TYPED_TEST(PoolAllocatorTypedTest, BasicAllocation) {
+  auto* ptr1{this->alloc->allocate()};
+  ASSERT_NE(ptr1, nullptr);
+
+  auto* ptr2{this->alloc->allocate()};
+  ASSERT_NE(ptr2, nullptr);
+
+  EXPECT_NE(ptr1, ptr2);
+  EXPECT_EQ(this->alloc->get_used(), 2 * this->block_size);
+}
+
+TYPED_TEST(PoolAllocatorTypedTest, BlocksAreAligned) {
+  for (size_t i{}; i < this->block_count; ++i) {
+    auto* ptr{this->alloc->allocate()};
+    ASSERT_NE(ptr, nullptr);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(ptr) % TypeParam::block_alignment,
+              0);
+  }
+}
+
+TYPED_TEST(PoolAllocatorTypedTest, ReturnsNullptrWhenExhausted) {
+  std::set<std::byte*> blocks{};
+  for (size_t i{}; i < this->block_count; ++i) {
+    auto* ptr{this->alloc->allocate()};
+    ASSERT_NE(ptr, nullptr);
+    blocks.insert(ptr);
+  }
+
+  EXPECT_EQ(blocks.size(), this->block_count);  // all distinct
+  EXPECT_EQ(this->alloc->allocate(), nullptr);
+  EXPECT_EQ(this->alloc->get_free(), 0);
+}
+
+TYPED_TEST(PoolAllocatorTypedTest, DeallocateAndReallocate) {
+  auto* ptr1{this->alloc->allocate()};
+  auto* ptr2{this->alloc->allocate()};
+  ASSERT_NE(ptr1, nullptr);
+  ASSERT_NE(ptr2, nullptr);
+
+  this->alloc->deallocate(ptr1);
+
+  auto* ptr3{this->alloc->allocate()};
+  EXPECT_EQ(ptr1, ptr3);  // most recently freed block is reused first
+}
+
+TYPED_TEST(PoolAllocatorTypedTest, ReusesFreedBlocksWhenFull) {
+  std::byte* blocks[this->block_count];
+  for (size_t i{}; i < this->block_count; ++i) {
+    blocks[i] = this->alloc->allocate();
+    ASSERT_NE(blocks[i], nullptr);
+  }
+
+  this->alloc->deallocate(blocks[3]);
+  this->alloc->deallocate(blocks[7]);
+
+  auto* ptr1{this->alloc->allocate()};
+  auto* ptr2{this->alloc->allocate()};
+  EXPECT_EQ(ptr1, blocks[7]);
+  EXPECT_EQ(ptr2, blocks[3]);
+  EXPECT_EQ(this->alloc->allocate(), nullptr);
+}
+
+TYPED_TEST(PoolAllocatorTypedTest, DeallocateNullptr) {
+  auto* ptr{this->alloc->allocate()};
+  ASSERT_NE(ptr, nullptr);
+
+  size_t used_before_dealloc{this->alloc->get_used()};
+  this->alloc->deallocate(nullptr);
+  EXPECT_EQ(this->alloc->get_used(), used_before_dealloc);
+}
+
+TYPED_TEST(PoolAllocatorTypedTest, DeallocateOutOfBoundsPointer) {
+  auto* valid{this->alloc->allocate()};
+  ASSERT_NE(valid, nullptr);
+
+  std::byte* invalid{valid + 10000};
+  EXPECT_DEATH(this->alloc->deallocate(invalid), "pointer is out of bounds");
+}
+
+TYPED_TEST(PoolAllocatorTypedTest, DeallocateMisalignedPointer) {
+  auto* valid{this->alloc->allocate()};
+  ASSERT_NE(valid, nullptr);
+
+  EXPECT_DEATH(this->alloc->deallocate(valid + 1),
+               "pointer is not a block boundary");
+}
+
+TYPED_TEST(PoolAllocatorTypedTest, ResetsSuccessfully) {
+  auto* ptr1{this->alloc->allocate()};
+  ASSERT_NE(ptr1, nullptr);
+
+  this->alloc->reset();
+  EXPECT_EQ(this->alloc->get_used(), 0);
+
+  auto* ptr2{this->alloc->allocate()};
+  EXPECT_EQ(ptr1, ptr2);  // should point to the same memory
+}
+
+TYPED_TEST(PoolAllocatorTypedTest, GetStateReportsBlocks) {
+  auto* ptr1{this->alloc->allocate()};
+  auto* ptr2{this->alloc->allocate()};
+  auto* ptr3{this->alloc->allocate()};
+
+  ASSERT_NE(ptr1, nullptr);
+  ASSERT_NE(ptr2, nullptr);
+  ASSERT_NE(ptr3, nullptr);
+
+  this->alloc->deallocate(ptr2);
+
+  // used | free | used | untouched remainder
+  std::string state{this->alloc->get_state()};
+  EXPECT_EQ(count_occurrences(state, "\"status\":\"used\""), 2);
+  EXPECT_EQ(count_occurrences(state, "\"status\":\"free\""), 2);
+  EXPECT_EQ(count_occurrences(state, "\"ptr\":null"), 2);
+}
+
+TYPED_TEST(PoolAllocatorTypedTest, EmplaceAllocatesAndCreatesInPlace) {
+  int a{15};
+  double b{3.14};
+  Obj* obj{this->alloc->template emplace<Obj>(a, b)};
+  ASSERT_NE(obj, nullptr);
+
+  // check construction
+  EXPECT_EQ(obj->x, a);
+  EXPECT_EQ(obj->y, b);
+
+  this->alloc->template destroy<Obj>(obj);
+  this->alloc->template deallocate<Obj>(obj);
+  EXPECT_EQ(this->alloc->get_used(), 0);
+}
+
+TYPED_TEST(PoolAllocatorTypedTest, DestroyCallsDestructor) {
+  TrackedObj::destructor_calls = 0;  // assign to 0 at start of each typed test
+
+  TrackedObj* obj1{this->alloc->template emplace<TrackedObj>(10)};
+  TrackedObj* obj2{this->alloc->template emplace<TrackedObj>(10)};
+  TrackedObj* obj3{this->alloc->template emplace<TrackedObj>(10)};
+
+  ASSERT_NE(obj1, nullptr);
+  ASSERT_NE(obj2, nullptr);
+  ASSERT_NE(obj3, nullptr);
+
+  this->alloc->template destroy(obj1);
+  this->alloc->template destroy(obj2);
+  this->alloc->template destroy(obj3);
+  EXPECT_EQ(TrackedObj::destructor_calls, 3);
+}
+
+TYPED_TEST(PoolAllocatorTypedTest, RemoteFreesReturnOnNextAllocation) {
+  if constexpr (TypeParam::concurrency != Concurrency::OWNER) {
+    GTEST_SKIP() << "only the owner may deallocate";
+  } else {
+    std::vector<std::byte*> blocks{};
+    while (std::byte* block{this->alloc->allocate()}) {
+      blocks.push_back(block);
+    }
+    ASSERT_EQ(blocks.size(), this->block_count);
+
+    std::thread worker{[&] {
+      for (std::byte* block : blocks) {
+        this->alloc->deallocate(block);
+      }
+    }};
+    worker.join();
+
+    // queued until the owner allocates again, which takes them all back
+    EXPECT_EQ(this->alloc->get_free(), 0);
+    EXPECT_NE(this->alloc->allocate(), nullptr);
+    EXPECT_EQ(this->alloc->get_used(), this->block_size);
+  }
+}
+
+TEST(PoolAllocatorTest, ProducerConsumerFreesAcrossThreads) {
+  constexpr size_t total{50000};
+  PoolAllocator<64, 64, BufferType::HEAP, Concurrency::OWNER> alloc{};
+
+  std::mutex mutex{};
+  std::queue<std::byte*> queue{};
+  std::atomic<bool> done{false};
+
+  // frees every block on a thread that never allocates
+  std::thread consumer{[&] {
+    while (true) {
+      std::byte* block{};
+      {
+        std::lock_guard lock{mutex};
+        if (!queue.empty()) {
+          block = queue.front();
+          queue.pop();
+        } else if (done.load()) {
+          return;
+        }
+      }
+      if (!block) {
+        std::this_thread::yield();
+        continue;
+      }
+
+      // stamped by the producer, a block handed out twice would differ
+      auto stamp{*reinterpret_cast<size_t*>(block)};
+      ASSERT_EQ(*reinterpret_cast<size_t*>(block + 56), stamp);
+      alloc.deallocate(block);
+    }
+  }};
+
+  for (size_t produced{}; produced < total;) {
+    std::byte* block{alloc.allocate()};
+    if (!block) {
+      std::this_thread::yield();  // full until the consumer catches up
+      continue;
+    }
+
+    *reinterpret_cast<size_t*>(block) = produced;
+    *reinterpret_cast<size_t*>(block + 56) = produced;
+    std::lock_guard lock{mutex};
+    queue.push(block);
+    ++produced;
+  }
+
+  done.store(true);
+  consumer.join();
+
+  for (size_t i{}; i < 64; ++i) {
+    EXPECT_NE(alloc.allocate(), nullptr);
+  }
+  EXPECT_EQ(alloc.get_free(), 0);
+}
+
+}  // namespace allocator::tests
@@ -0,0 +1,89 @@
+#include "scoped_arena.h"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+
+#include "growable_linear_allocator.h"
+#include "linear_allocator.h"
+
+namespace allocator::tests {
+template <typename Allocator>
+class ScopedArenaTypedTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    if constexpr (requires { typename Allocator::upstream_type; }) {
+      alloc = std::make_unique<Allocator>(1024);
+    } else if constexpr (Allocator::extent == dynamic_extent) {
+      alloc = std::make_unique<Allocator>(4096);
+    } else {
+      alloc = std::make_unique<Allocator>();
+    }
+  }
+
+  std::unique_ptr<Allocator> alloc{};
+};
+
+using AllocatorTypes =
+    ::testing::Types<LinearAllocator<4096>,
+                     LinearAllocator<4096, BufferType::HEAP, Tracking::DEBUG>,
+                     LinearAllocator<dynamic_extent>,
+                     GrowableLinearAllocator<>>;
+
+TYPED_TEST_SUITE(ScopedArenaTypedTest, AllocatorTypes);
+
+TYPED_TEST(ScopedArenaTypedTest, ReleasesOnScopeExit) {
+  auto* outer{this->alloc->allocate(64, 8)};
+  ASSERT_NE(outer, nullptr);
+
+  std::byte* scoped{};
+  {
+    ScopedArena arena{*this->alloc};
+    scoped = this->alloc->allocate(256, 8);
+    ASSERT_NE(scoped, nullptr);
+  }
+
+  EXPECT_EQ(this->alloc->allocate(256, 8), scoped);
+}
+
+TYPED_TEST(ScopedArenaTypedTest, NestedScopesReleaseInLifoOrder) {
+  ScopedArena outer{*this->alloc};
+  auto* a{this->alloc->allocate(64, 8)};
+  ASSERT_NE(a, nullptr);
+
+  std::byte* b{};
+  {
+    ScopedArena middle{*this->alloc};
+    b = this->alloc->allocate(64, 8);
+    ASSERT_NE(b, nullptr);
+
+    std::byte* c{};
+    {
+      ScopedArena inner{*this->alloc};
+      c = this->alloc->allocate(64, 8);
+      ASSERT_NE(c, nullptr);
+    }
+
+    // only the innermost temporaries were released
+    EXPECT_EQ(this->alloc->allocate(64, 8), c);
+  }
+
+  EXPECT_EQ(this->alloc->allocate(64, 8), b);
+}
+
+TYPED_TEST(ScopedArenaTypedTest, RewindReleasesWithinScope) {
+  ScopedArena arena{*this->alloc};
+  EXPECT_EQ(&arena.get_allocator(), this->alloc.get());
+
+  std::byte* first{this->alloc->allocate(1024, 8)};
+  ASSERT_NE(first, nullptr);
+  arena.rewind();
+
+  // each pass reuses the same memory, where 8 passes would not fit
+  for (int i{}; i < 8; ++i) {
+    EXPECT_EQ(this->alloc->allocate(1024, 8), first);
+    arena.rewind();
+  }
+}
+
+}  // namespace allocator::tests
@@ -0,0 +1,221 @@
+#include "sharded_allocator.h"
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <set>
+#include <span>
+#include <thread>
+#include <vector>
+
+#include "buddy_allocator.h"
+#include "free_list_allocator.h"
+
+namespace allocator::tests {
+template <typename Allocator>
+class ShardedAllocatorTypedTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    if constexpr (Allocator::buffer_type == BufferType::EXTERNAL) {
+      alloc = std::make_unique<Allocator>(std::span<std::byte>{buf});
+    } else {
+      alloc = std::make_unique<Allocator>(buf_size);
+    }
+  }
+
+  std::unique_ptr<Allocator> alloc{};
+
+  static constexpr size_t thread_count{4};
+
+  // for buffertype::external allocator
+  static constexpr size_t buf_size{65536};
+  alignas(cache_line_size) std::array<std::byte, buf_size> buf{};
+};
+
+using FreeListShard = FreeListAllocator<dynamic_extent, BufferType::EXTERNAL>;
+using BestFitShard = FreeListAllocator<dynamic_extent, BufferType::EXTERNAL,
+                                       FitStrategy::BEST>;
+using BuddyShard = BuddyAllocator<dynamic_extent, BufferType::EXTERNAL>;
+
+using AllocatorTypes = ::testing::Types<
+    ShardedAllocator<FreeListShard, 4>,                        // heap
+    ShardedAllocator<BestFitShard, 4, BufferType::EXTERNAL>,   // external
+    ShardedAllocator<BuddyShard, 4, BufferType::MMAP>,         // mapped
+    ShardedAllocator<FreeListShard, 4, BufferType::HEAP,
+                     Affinity::THREAD>>;                       // by thread
+
+TYPED_TEST_SUITE(ShardedAllocatorTypedTest, AllocatorTypes);
+
+TYPED_TEST(ShardedAllocatorTypedTest, BasicAllocation) {
+  auto* ptr1{this->alloc->allocate(100, 8)};
+  ASSERT_NE(ptr1, nullptr);
+
+  auto* ptr2{this->alloc->allocate(100, 8)};
+  ASSERT_NE(ptr2, nullptr);
+
+  EXPECT_NE(ptr1, ptr2);
+  EXPECT_GT(this->alloc->get_used(), 0);
+}
+
+TYPED_TEST(ShardedAllocatorTypedTest, AllocatesFromHomeShard) {
+  size_t home{this->alloc->get_home_shard()};
+  ASSERT_LT(home, TypeParam::shard_count);
+
+  auto* ptr{this->alloc->allocate(64, 8)};
+  ASSERT_NE(ptr, nullptr);
+  EXPECT_EQ(this->alloc->get_shard(ptr), home);
+}
+
+TYPED_TEST(ShardedAllocatorTypedTest, SpillsIntoOtherShardsWhenFull) {
+  // a quarter of the buffer fits in one shard at most, so filling it takes
+  // every shard
+  std::set<size_t> touched{};
+  std::vector<std::byte*> blocks{};
+  while (std::byte* block{this->alloc->allocate(1024, 8)}) {
+    touched.insert(this->alloc->get_shard(block));
+    blocks.push_back(block);
+  }
+
+  EXPECT_EQ(touched.size(), TypeParam::shard_count);
+  EXPECT_GT(blocks.size(), TypeParam::shard_count * 8);
+
+  for (std::byte* block : blocks) {
+    this->alloc->deallocate(block);
+  }
+  EXPECT_EQ(this->alloc->get_used(), 0);
+}
+
+TYPED_TEST(ShardedAllocatorTypedTest, CrossThreadFreeReturnsToOwner) {
+  std::vector<std::byte*> blocks{};
+  std::vector<size_t> owners{};
+  for (int i{}; i < 32; ++i) {
+    blocks.push_back(this->alloc->allocate(48, 8));
+    ASSERT_NE(blocks.back(), nullptr);
+    owners.push_back(this->alloc->get_shard(blocks.back()));
+  }
+
+  std::thread worker{[this, &blocks] {
+    for (std::byte* block : blocks) {
+      this->alloc->deallocate(block);
+    }
+  }};
+  worker.join();
+
+  EXPECT_EQ(this->alloc->get_used(), 0);
+
+  // freed to the shard that handed it out, so it comes back from there
+  auto* ptr{this->alloc->allocate(48, 8)};
+  ASSERT_NE(ptr, nullptr);
+  EXPECT_EQ(this->alloc->get_shard(ptr), owners.front());
+}
+
+TYPED_TEST(ShardedAllocatorTypedTest, ConcurrentAllocationsDoNotOverlap) {
+  constexpr int rounds{200};
+  constexpr size_t live{16};
+
+  // each thread frees the blocks of the next one, so most frees cross
+  // shards
+  std::array<std::array<std::byte*, live>, TestFixture::thread_count>
+      handoff{};
+  std::vector<std::thread> workers{};
+  for (size_t t{}; t < this->thread_count; ++t) {
+    workers.emplace_back([this, t, &handoff] {
+      std::mt19937 rng{static_cast<unsigned>(t)};
+      std::uniform_int_distribution<size_t> sizes{16, 256};
+      auto tag{static_cast<std::byte>(t + 1)};
+
+      for (int round{}; round < rounds; ++round) {
+        std::array<std::byte*, live> blocks{};
+        std::array<size_t, live> lengths{};
+        for (size_t i{}; i < live; ++i) {
+          lengths[i] = sizes(rng);
+          blocks[i] = this->alloc->allocate(lengths[i], 8);
+          ASSERT_NE(blocks[i], nullptr);
+          std::memset(blocks[i], static_cast<int>(tag), lengths[i]);
+        }
+
+        // another thread writing into these blocks would change the tag
+        for (size_t i{}; i < live; ++i) {
+          for (size_t j{}; j < lengths[i]; ++j) {
+            ASSERT_EQ(blocks[i][j], tag);
+          }
+          this->alloc->deallocate(blocks[i]);
+        }
+      }
+
+      for (auto& block : handoff[t]) {
+        block = this->alloc->allocate(64, 8);
+      }
+    });
+  }
+
+  for (auto& worker : workers) {
+    worker.join();
+  }
+
+  workers.clear();
+  for (size_t t{}; t < this->thread_count; ++t) {
+    workers.emplace_back([this, t, &handoff] {
+      for (std::byte* block : handoff[(t + 1) % this->thread_count]) {
+        this->alloc->deallocate(block);
+      }
+    });
+  }
+
+  for (auto& worker : workers) {
+    worker.join();
+  }
+
+  EXPECT_EQ(this->alloc->get_used(), 0);
+}
+
+TYPED_TEST(ShardedAllocatorTypedTest, ResetClearsEveryShard) {
+  while (this->alloc->allocate(1024, 8)) {
+  }
+  EXPECT_GT(this->alloc->get_used(), 0);
+
+  this->alloc->reset();
+  EXPECT_EQ(this->alloc->get_used(), 0);
+  EXPECT_NE(this->alloc->allocate(1024, 8), nullptr);
+}
+
+TYPED_TEST(ShardedAllocatorTypedTest, EmplaceAllocatesAndCreatesInPlace) {
+  int a{15};
+  double b{3.14};
+  Obj* obj{this->alloc->template emplace<Obj>(a, b)};
+  ASSERT_NE(obj, nullptr);
+
+  // check construction
+  EXPECT_EQ(obj->x, a);
+  EXPECT_EQ(obj->y, b);
+
+  this->alloc->template destroy<Obj>(obj);
+  this->alloc->template deallocate<Obj>(obj);
+  EXPECT_EQ(this->alloc->get_used(), 0);
+}
+
+TEST(ShardedAllocatorBuddyTest, SlicesArePowersOfTwo) {
+  // 65536 / 3 rounds down to 16384 per shard, the rest is the unused tail
+  ShardedAllocator<BuddyShard, 3> alloc{65536};
+  EXPECT_EQ(alloc.get_free(), 3 * 16384);
+
+  // each shard serves a whole slice, and frees go back to it by address
+  std::vector<std::byte*> blocks{};
+  while (std::byte* ptr{alloc.allocate(16384, 8)}) {
+    blocks.push_back(ptr);
+  }
+  ASSERT_EQ(blocks.size(), 3);
+
+  std::set<size_t> owners{};
+  for (std::byte* ptr : blocks) {
+    owners.insert(alloc.get_shard(ptr));
+    alloc.deallocate(ptr);
+  }
+  EXPECT_EQ(owners.size(), 3);
+  EXPECT_EQ(alloc.get_used(), 0);
+}
+
+}  // namespace allocator::tests
@@ -0,0 +1,105 @@
+#include "stl_adapter.h"
+
+#include <gtest/gtest.h>
+
+#include <list>
+#include <map>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "buddy_allocator.h"
+#include "free_list_allocator.h"
+#include "linear_allocator.h"
+
+namespace allocator::tests {
+template <typename Allocator>
+class StlAdapterTypedTest : public ::testing::Test {
+ protected:
+  std::unique_ptr<Allocator> alloc{std::make_unique<Allocator>()};
+
+  template <typename T>
+  StlAdapter<T, Allocator> adapter() {
+    return StlAdapter<T, Allocator>{*alloc};
+  }
+};
+
+using AllocatorTypes =
+    ::testing::Types<LinearAllocator<8192>, FreeListAllocator<8192>,
+                     BuddyAllocator<8192>>;
+
+TYPED_TEST_SUITE(StlAdapterTypedTest, AllocatorTypes);
+
+TYPED_TEST(StlAdapterTypedTest, BacksVector) {
+  std::vector<int, StlAdapter<int, TypeParam>> values{
+      this->template adapter<int>()};
+  for (int i{}; i < 100; ++i) {
+    values.push_back(i);
+  }
+
+  for (int i{}; i < 100; ++i) {
+    EXPECT_EQ(values[i], i);
+  }
+}
+
+TYPED_TEST(StlAdapterTypedTest, BacksNodeContainers) {
+  using Pair = std::pair<const int, int>;
+  std::map<int, int, std::less<int>, StlAdapter<Pair, TypeParam>> map{
+      this->template adapter<Pair>()};
+  std::list<int, StlAdapter<int, TypeParam>> list{
+      this->template adapter<int>()};
+
+  for (int i{}; i < 32; ++i) {
+    map.emplace(i, i * 2);
+    list.push_back(i);
+  }
+
+  EXPECT_EQ(map.size(), 32);
+  EXPECT_EQ(map.at(7), 14);
+  EXPECT_EQ(list.back(), 31);
+}
+
+TYPED_TEST(StlAdapterTypedTest, RebindsToOtherTypes) {
+  using Rebound = typename std::allocator_traits<
+      StlAdapter<int, TypeParam>>::template rebind_alloc<double>;
+  static_assert(std::is_same_v<Rebound, StlAdapter<double, TypeParam>>);
+
+  StlAdapter<int, TypeParam> ints{this->template adapter<int>()};
+  StlAdapter<double, TypeParam> doubles{ints};
+  EXPECT_EQ(&doubles.get_allocator(), this->alloc.get());
+  EXPECT_TRUE(ints == doubles);
+}
+
+TYPED_TEST(StlAdapterTypedTest, EqualWhenSharingAllocator) {
+  TypeParam other_alloc{};
+  StlAdapter<int, TypeParam> other{other_alloc};
+
+  EXPECT_TRUE(this->template adapter<int>() == this->template adapter<int>());
+  EXPECT_FALSE(this->template adapter<int>() == other);
+}
+
+TYPED_TEST(StlAdapterTypedTest, PropagatesWithContainer) {
+  using Traits = std::allocator_traits<StlAdapter<int, TypeParam>>;
+  static_assert(Traits::propagate_on_container_copy_assignment::value);
+  static_assert(Traits::propagate_on_container_move_assignment::value);
+  static_assert(Traits::propagate_on_container_swap::value);
+  static_assert(!Traits::is_always_equal::value);
+
+  TypeParam other_alloc{};
+  std::vector<int, StlAdapter<int, TypeParam>> values{
+      this->template adapter<int>()};
+  std::vector<int, StlAdapter<int, TypeParam>> other{
+      StlAdapter<int, TypeParam>{other_alloc}};
+
+  values = std::move(other);
+  EXPECT_EQ(&values.get_allocator().get_allocator(), &other_alloc);
+}
+
+TYPED_TEST(StlAdapterTypedTest, ThrowsWhenOutOfMemory) {
+  StlAdapter<int, TypeParam> ints{this->template adapter<int>()};
+  EXPECT_THROW((void)ints.allocate(8192), std::bad_alloc);
+}
+
+}  // namespace allocator::tests
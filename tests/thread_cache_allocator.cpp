@@ -0,0 +1,188 @@
+#include "thread_cache_allocator.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "buddy_allocator.h"
+#include "free_list_allocator.h"
+
+namespace allocator::tests {
+template <typename Allocator>
+class ThreadCacheAllocatorTypedTest : public ::testing::Test {
+ protected:
+  std::unique_ptr<Allocator> alloc{std::make_unique<Allocator>()};
+
+  static constexpr size_t thread_count{4};
+};
+
+using AllocatorTypes =
+    ::testing::Types<ThreadCacheAllocator<FreeListAllocator<65536>, 256, 8>,
+                     ThreadCacheAllocator<BuddyAllocator<65536>, 256, 8>>;
+
+TYPED_TEST_SUITE(ThreadCacheAllocatorTypedTest, AllocatorTypes);
+
+TYPED_TEST(ThreadCacheAllocatorTypedTest, BasicAllocation) {
+  auto* ptr1{this->alloc->allocate(100)};
+  ASSERT_NE(ptr1, nullptr);
+
+  auto* ptr2{this->alloc->allocate(100)};
+  ASSERT_NE(ptr2, nullptr);
+
+  EXPECT_NE(ptr1, ptr2);
+}
+
+TYPED_TEST(ThreadCacheAllocatorTypedTest, RefillsInBatches) {
+  auto* ptr{this->alloc->allocate(64)};
+  ASSERT_NE(ptr, nullptr);
+
+  // a whole batch was taken from the backend, not just one block
+  size_t used{this->alloc->get_used()};
+  EXPECT_GE(used, 8 * 64);
+
+  for (int i{}; i < 7; ++i) {
+    ASSERT_NE(this->alloc->allocate(64), nullptr);
+  }
+  EXPECT_EQ(this->alloc->get_used(), used);
+}
+
+TYPED_TEST(ThreadCacheAllocatorTypedTest, RefillCarvesOneFreeBlock) {
+  // the batch comes from one bulk call, so a fresh arena yields neighbours
+  std::vector<std::byte*> blocks{};
+  for (int i{}; i < 8; ++i) {
+    blocks.push_back(this->alloc->allocate(64));
+    ASSERT_NE(blocks.back(), nullptr);
+  }
+
+  std::ranges::sort(blocks);
+  EXPECT_LE(blocks.back() - blocks.front(), 8 * 128);
+}
+
+TYPED_TEST(ThreadCacheAllocatorTypedTest, RejectsOverAlignedTypes) {
+  struct alignas(64) Aligned {
+    int value;
+  };
+  EXPECT_EQ(this->alloc->template allocate<Aligned>(), nullptr);
+  EXPECT_EQ(this->alloc->template emplace<Aligned>(1), nullptr);
+  EXPECT_EQ(this->alloc->get_used(), 0);
+}
+
+TYPED_TEST(ThreadCacheAllocatorTypedTest, ReusesMostRecentlyFreedBlock) {
+  auto* ptr1{this->alloc->allocate(32)};
+  ASSERT_NE(ptr1, nullptr);
+
+  this->alloc->deallocate(ptr1, 32);
+
+  auto* ptr2{this->alloc->allocate(32)};
+  EXPECT_EQ(ptr1, ptr2);
+}
+
+TYPED_TEST(ThreadCacheAllocatorTypedTest, LargeAllocationsBypassCache) {
+  auto* ptr{this->alloc->allocate(4096)};
+  ASSERT_NE(ptr, nullptr);
+  EXPECT_GE(this->alloc->get_used(), 4096);
+
+  this->alloc->deallocate(ptr, 4096);
+  EXPECT_EQ(this->alloc->get_used(), 0);
+}
+
+TYPED_TEST(ThreadCacheAllocatorTypedTest, FlushReturnsCachedBlocks) {
+  std::vector<std::byte*> blocks{};
+  for (int i{}; i < 20; ++i) {
+    blocks.push_back(this->alloc->allocate(48));
+    ASSERT_NE(blocks.back(), nullptr);
+  }
+
+  for (std::byte* block : blocks) {
+    this->alloc->deallocate(block, 48);
+  }
+  EXPECT_GT(this->alloc->get_used(), 0);
+
+  this->alloc->flush();
+  EXPECT_EQ(this->alloc->get_used(), 0);
+}
+
+TYPED_TEST(ThreadCacheAllocatorTypedTest, ThreadExitReturnsCachedBlocks) {
+  std::thread worker{[this] {
+    auto* ptr{this->alloc->allocate(128)};
+    ASSERT_NE(ptr, nullptr);
+    this->alloc->deallocate(ptr, 128);
+  }};
+  worker.join();
+
+  EXPECT_EQ(this->alloc->get_used(), 0);
+}
+
+TYPED_TEST(ThreadCacheAllocatorTypedTest, ConcurrentAllocationsDoNotOverlap) {
+  constexpr int rounds{200};
+  constexpr size_t live{16};
+
+  std::vector<std::thread> workers{};
+  for (size_t t{}; t < this->thread_count; ++t) {
+    workers.emplace_back([this, t] {
+      std::array<std::byte*, live> blocks{};
+      auto tag{static_cast<std::byte>(t + 1)};
+
+      for (int round{}; round < rounds; ++round) {
+        for (auto& block : blocks) {
+          block = this->alloc->allocate(64);
+          ASSERT_NE(block, nullptr);
+          std::memset(block, static_cast<int>(tag), 64);
+        }
+
+        // another thread writing into these blocks would change the tag
+        for (auto* block : blocks) {
+          for (size_t i{}; i < 64; ++i) {
+            ASSERT_EQ(block[i], tag);
+          }
+          this->alloc->deallocate(block, 64);
+        }
+      }
+      this->alloc->flush();
+    });
+  }
+
+  for (auto& worker : workers) {
+    worker.join();
+  }
+
+  EXPECT_EQ(this->alloc->get_used(), 0);
+}
+
+TYPED_TEST(ThreadCacheAllocatorTypedTest, CrossThreadDeallocation) {
+  std::vector<std::byte*> blocks{};
+  for (int i{}; i < 32; ++i) {
+    blocks.push_back(this->alloc->allocate(16));
+    ASSERT_NE(blocks.back(), nullptr);
+  }
+
+  std::thread worker{[this, &blocks] {
+    for (std::byte* block : blocks) {
+      this->alloc->deallocate(block, 16);
+    }
+  }};
+  worker.join();
+
+  this->alloc->flush();
+  EXPECT_EQ(this->alloc->get_used(), 0);
+}
+
+TYPED_TEST(ThreadCacheAllocatorTypedTest, EmplaceAllocatesAndCreatesInPlace) {
+  int a{15};
+  double b{3.14};
+  Obj* obj{this->alloc->template emplace<Obj>(a, b)};
+  ASSERT_NE(obj, nullptr);
+
+  // check construction
+  EXPECT_EQ(obj->x, a);
+  EXPECT_EQ(obj->y, b);
+
+  this->alloc->template destroy<Obj>(obj);
+  this->alloc->template deallocate<Obj>(obj);
+}
+
+}  // namespace allocator::tests